@@ -0,0 +1,178 @@
+"""
+Read the binary relation files that ddisasm writes to the debug directory
+with `--debug-dir-format binary` or `--debug-dir-format compressed`, and
+convert them to the CSV files that ddisasm writes by default.
+
+Each file holds an 8-byte header (the magic `DDRB`, a version byte, a flags
+byte and two reserved bytes), followed by the body, compressed with zlib if
+bit 0 of the flags is set. The body holds the arity, the tuple count, the
+name and type of each attribute, a table of the symbols and records of the
+relation, and one column per attribute: 32-bit indices into the table for
+symbols and records, and 64-bit values for the other attributes. All
+integers are little-endian.
+
+The same encoding is used for the relations of the `souffleFactsBinary` and
+`souffleOutputsBinary` aux data tables written by
+`--with-souffle-relations --souffle-relations-format binary` (or
+`compressed`), which `aux_data_relations` decodes.
+"""
+import argparse
+import struct
+import sys
+import zlib
+from pathlib import Path
+from typing import Dict, Iterator, List, NamedTuple, Tuple
+
+MAGIC = b"DDRB"
+VERSION = 1
+FLAG_COMPRESSED = 1
+HEADER_SIZE = 8
+
+__all__ = [
+    "Relation",
+    "aux_data_relations",
+    "decode_relation",
+    "read_relation",
+    "to_csv",
+]
+
+
+class Relation(NamedTuple):
+    names: List[str]
+    types: List[str]
+    rows: List[tuple]
+
+
+class _Reader:
+    def __init__(self, data: bytes):
+        self.data = data
+        self.pos = 0
+
+    def unpack(self, fmt: str) -> Tuple:
+        values = struct.unpack_from(fmt, self.data, self.pos)
+        self.pos += struct.calcsize(fmt)
+        return values
+
+    def string(self) -> str:
+        (size,) = self.unpack("<I")
+        value = self.data[self.pos : self.pos + size]
+        if len(value) != size:
+            raise ValueError("truncated relation")
+        self.pos += size
+        return value.decode("utf-8", errors="surrogateescape")
+
+
+def _column(reader: _Reader, kind: str, count: int, texts: List[str]):
+    if kind in "sr":
+        values = reader.unpack(f"<{count}I")
+        return [texts[value] for value in values]
+    fmt = {"i": "q", "f": "d"}.get(kind, "Q")
+    return list(reader.unpack(f"<{count}{fmt}"))
+
+
+def decode_relation(data: bytes) -> Relation:
+    """
+    Decode the contents of a binary relation file.
+    """
+    if len(data) < HEADER_SIZE or data[:4] != MAGIC:
+        raise ValueError("not a binary relation")
+    version, flags = data[4], data[5]
+    if version != VERSION:
+        raise ValueError(f"unsupported binary relation version {version}")
+    body = data[HEADER_SIZE:]
+    if flags & FLAG_COMPRESSED:
+        body = zlib.decompress(body)
+
+    reader = _Reader(body)
+    arity, count = reader.unpack("<IQ")
+    names, types = [], []
+    for _ in range(arity):
+        names.append(reader.string())
+        types.append(reader.string())
+    (text_count,) = reader.unpack("<I")
+    texts = [reader.string() for _ in range(text_count)]
+    columns = [_column(reader, t[0], count, texts) for t in types]
+    if reader.pos != len(body):
+        raise ValueError("trailing data after relation")
+    if arity == 0:
+        return Relation(names, types, [()] * count)
+    return Relation(names, types, list(zip(*columns)))
+
+
+def read_relation(path: Path) -> Relation:
+    """
+    Read a binary relation file.
+    """
+    with open(path, "rb") as f:
+        return decode_relation(f.read())
+
+
+def aux_data_relations(module, table: str) -> Dict[str, Relation]:
+    """
+    Decode the relations of the "souffleFactsBinary" or
+    "souffleOutputsBinary" aux data table of a gtirb.Module, indexed by
+    their namespaced name, e.g. "disassembly.block_points".
+    """
+    return {
+        name: decode_relation(bytes(data))
+        for name, data in module.aux_data[table].data.items()
+    }
+
+
+def _format_field(value, type_: str) -> str:
+    if type_ == "u:address":
+        return hex(value) if value else "0"
+    if type_[0] == "f":
+        return f"{value:g}"
+    return str(value)
+
+
+def to_csv(relation: Relation) -> Iterator[str]:
+    """
+    Yield the lines of the relation in the tab-separated format of the CSV
+    files of the debug directory.
+    """
+    for row in relation.rows:
+        yield "\t".join(
+            _format_field(value, type_)
+            for value, type_ in zip(row, relation.types)
+        ) + "\n"
+
+
+def _csv_path(path: Path) -> Path:
+    # "name.facts.bin" becomes "name.facts", and "name.bin" becomes "name.csv".
+    # Relation names of components contain dots, e.g. "reg_def_use.def_used".
+    name = path.name
+    if name.endswith(".facts.bin"):
+        return path.with_name(name[: -len(".bin")])
+    if name.endswith(".bin"):
+        return path.with_name(name[: -len(".bin")] + ".csv")
+    return path.with_name(name + ".csv")
+
+
+def _main() -> int:
+    parser = argparse.ArgumentParser(description=__doc__.strip())
+    parser.add_argument("files", nargs="+", type=Path)
+    parser.add_argument(
+        "--stdout",
+        action="store_true",
+        help="print the relations instead of writing them next to the files",
+    )
+    args = parser.parse_args()
+
+    for path in args.files:
+        try:
+            relation = read_relation(path)
+        except (OSError, ValueError, struct.error, zlib.error) as e:
+            print(f"error: {path}: {e}", file=sys.stderr)
+            return 1
+        if args.stdout:
+            sys.stdout.writelines(to_csv(relation))
+        else:
+            with open(_csv_path(path), "w") as f:
+                f.writelines(to_csv(relation))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(_main())
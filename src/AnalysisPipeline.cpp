@@ -32,6 +32,28 @@ void AnalysisPipeline::configureDebugDir(const std::string &DebugDirRoot, bool M
     }
 }
 
+void AnalysisPipeline::setDebugDirFormat(DatalogIO::RelationFormat Format)
+{
+    for(auto &Pass : Passes)
+    {
+        if(DatalogAnalysisPass *DatalogPass = dynamic_cast<DatalogAnalysisPass *>(Pass.get()))
+        {
+            DatalogPass->setDebugDirFormat(Format);
+        }
+    }
+}
+
+void AnalysisPipeline::setRelationFilter(const DatalogIO::RelationFilter &Filter)
+{
+    for(auto &Pass : Passes)
+    {
+        if(DatalogAnalysisPass *DatalogPass = dynamic_cast<DatalogAnalysisPass *>(Pass.get()))
+        {
+            DatalogPass->setRelationFilter(Filter);
+        }
+    }
+}
+
 void AnalysisPipeline::setDatalogThreadCount(unsigned int Count)
 {
     for(auto &Pass : Passes)
@@ -54,13 +76,13 @@ void AnalysisPipeline::setDatalogProfileDir(const std::string &ProfileDir)
     }
 }
 
-void AnalysisPipeline::enableSouffleOutputs()
+void AnalysisPipeline::enableSouffleOutputs(DatalogIO::RelationFormat Format)
 {
     for(auto &Pass : Passes)
     {
         if(DatalogAnalysisPass *DatalogPass = dynamic_cast<DatalogAnalysisPass *>(Pass.get()))
         {
-            DatalogPass->enableSouffleOutputs();
+            DatalogPass->enableSouffleOutputs(true, Format);
         }
     }
 }
@@ -96,6 +118,14 @@ void AnalysisPipeline::loadHints(const std::string &Path)
     DatalogHints.read(Path, getPassSlugs());
 }
 
+void AnalysisPipeline::notifyModuleBegin(const gtirb::Module &Module)
+{
+    for(auto &Listener : Listeners)
+    {
+        Listener->notifyModuleBegin(Module);
+    }
+}
+
 void AnalysisPipeline::notifyPassBegin(const AnalysisPass &Name)
 {
     for(auto &Listener : Listeners)
@@ -128,10 +158,20 @@ void AnalysisPipeline::notifyPassResult(AnalysisPassPhase Phase, const AnalysisP
 
 void AnalysisPipeline::run(gtirb::Context &Context, gtirb::Module &Module)
 {
+    std::unique_lock<std::mutex> Lock;
+    if(IRMutex)
+    {
+        Lock = std::unique_lock<std::mutex>(*IRMutex);
+    }
+
+    notifyModuleBegin(Module);
+
     AnalysisPass *PreviousPass = nullptr;
     for(auto &Pass : Passes)
     {
         notifyPassBegin(*Pass);
+        Pass->receiveDecodedInstructions(PreviousPass);
+
         notifyPassPhase(AnalysisPassPhase::LOAD, Pass->hasLoad());
         if(Pass->hasLoad())
         {
@@ -151,7 +191,16 @@ void AnalysisPipeline::run(gtirb::Context &Context, gtirb::Module &Module)
         }
 
         notifyPassPhase(AnalysisPassPhase::ANALYZE);
+        bool Unlocked = Lock.owns_lock() && Pass->hasThreadSafeAnalyze();
+        if(Unlocked)
+        {
+            Lock.unlock();
+        }
         auto Result = Pass->analyze(Module);
+        if(Unlocked)
+        {
+            Lock.lock();
+        }
         notifyPassResult(AnalysisPassPhase::ANALYZE, Result);
 
         notifyPassPhase(AnalysisPassPhase::TRANSFORM, Pass->hasTransform());
@@ -22,7 +22,10 @@
 //===----------------------------------------------------------------------===//
 #ifndef _ANALYSIS_PIPELINE_H_
 #define _ANALYSIS_PIPELINE_H_
+#include <mutex>
+
 #include "Hints.h"
+#include "gtirb-decoder/DatalogIO.h"
 #include "passes/AnalysisPass.h"
 
 enum AnalysisPassPhase
@@ -40,6 +43,14 @@ It is intended for implementation of user interfaces.
 class AnalysisPipelineListener
 {
 public:
+    virtual ~AnalysisPipelineListener() = default;
+
+    /**
+    Called once before the passes of the pipeline run on Module.
+    */
+    virtual void notifyModuleBegin([[maybe_unused]] const gtirb::Module& Module)
+    {
+    }
     virtual void notifyPassBegin(const AnalysisPass& Name) = 0;
     virtual void notifyPassEnd(const AnalysisPass& Pass) = 0;
     virtual void notifyPassPhase(AnalysisPassPhase Phase, bool HasPhase = true) = 0;
@@ -61,17 +72,31 @@ public:
     }
 
     void configureDebugDir(const std::string& DebugDirRoot, bool MultiModule);
+    void setDebugDirFormat(DatalogIO::RelationFormat Format);
+    void setRelationFilter(const DatalogIO::RelationFilter& Filter);
     void setDatalogThreadCount(unsigned int Count);
     void setDatalogProfileDir(const std::string& ProfileDir);
-    void enableSouffleOutputs();
+    void enableSouffleOutputs(DatalogIO::RelationFormat Format = DatalogIO::RelationFormat::CSV);
     void configureSouffleInterpreter(const std::string& InterpreterDir,
                                      const std::string& LibraryDir);
     void loadHints(const std::string& Path);
 
+    /**
+    Share the IR with pipelines running on other modules concurrently.
+
+    The pipeline holds Mutex while it accesses the GTIRB, and releases it only
+    during the analyze phase of passes with a thread-safe analysis.
+    */
+    void setIRMutex(std::mutex* Mutex)
+    {
+        IRMutex = Mutex;
+    }
+
     void run(gtirb::Context& Context, gtirb::Module& Module);
 
 private:
     std::set<std::string> getPassSlugs();
+    void notifyModuleBegin(const gtirb::Module& Module);
     void notifyPassBegin(const AnalysisPass& Name);
     void notifyPassEnd(const AnalysisPass& Pass);
     void notifyPassPhase(AnalysisPassPhase Phase, bool HasPhase = true);
@@ -80,5 +105,6 @@ private:
     std::list<std::shared_ptr<AnalysisPipelineListener>> Listeners;
     std::list<std::unique_ptr<AnalysisPass>> Passes;
     HintsLoader DatalogHints;
+    std::mutex* IRMutex = nullptr;
 };
 #endif /* _ANALYSIS_PIPELINE_H_ */
@@ -155,6 +155,22 @@ namespace gtirb
             typedef std::map<std::string, std::tuple<std::string, std::string>> Type;
         };
 
+        /// \brief Auxiliary data for Souffle fact files in the binary relation format.
+        struct SouffleFactsBinary
+        {
+            static constexpr const char* Name = "souffleFactsBinary";
+            // Entries of the form {Name, BinaryRelation}.
+            typedef std::map<std::string, std::vector<uint8_t>> Type;
+        };
+
+        /// \brief Auxiliary data for Souffle output files in the binary relation format.
+        struct SouffleOutputsBinary
+        {
+            static constexpr const char* Name = "souffleOutputsBinary";
+            // Entries of the form {Name, BinaryRelation}.
+            typedef std::map<std::string, std::vector<uint8_t>> Type;
+        };
+
         /// \brief Auxiliary data for the list of possible entry points in a raw binary.
         struct RawEntries
         {
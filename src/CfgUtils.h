@@ -0,0 +1,105 @@
+//===- CfgUtils.h -----------------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2023 GrammaTech, Inc.
+//
+//  This code is licensed under the GNU Affero General Public License
+//  as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version. See the
+//  LICENSE.txt file in the project root for license terms or visit
+//  https://www.gnu.org/licenses/agpl.txt.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU Affero General Public License for more details.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+#ifndef _CFG_UTILS_H_
+#define _CFG_UTILS_H_
+
+#include <algorithm>
+#include <gtirb/gtirb.hpp>
+#include <optional>
+#include <vector>
+
+/**
+Get the module containing a CFG node, or nullptr for a detached block.
+
+The CFG is shared by all modules of an IR, so passes use this to restrict
+themselves to the vertices and edges of the module they analyze.
+*/
+inline const gtirb::Module* getCfgNodeModule(const gtirb::CfgNode* Node)
+{
+    if(const gtirb::CodeBlock* Block = gtirb::dyn_cast<gtirb::CodeBlock>(Node))
+    {
+        const gtirb::ByteInterval* ByteInterval = Block->getByteInterval();
+        const gtirb::Section* Section = ByteInterval ? ByteInterval->getSection() : nullptr;
+        return Section ? Section->getModule() : nullptr;
+    }
+    if(const gtirb::ProxyBlock* Proxy = gtirb::dyn_cast<gtirb::ProxyBlock>(Node))
+    {
+        return Proxy->getModule();
+    }
+    return nullptr;
+}
+
+/**
+Get the CFG vertex of a node, or nothing if the node is not in the CFG.
+*/
+inline std::optional<gtirb::CFG::vertex_descriptor> getCfgVertex(const gtirb::CFG& Cfg,
+                                                                 const gtirb::CfgNode* Node)
+{
+    const auto& Vertices = Cfg[boost::graph_bundle];
+    if(auto It = Vertices.find(Node); It != Vertices.end())
+    {
+        return It->second;
+    }
+    return std::nullopt;
+}
+
+/**
+Get the CFG vertices of a module: those of its code blocks, by address, and then those of
+its proxy blocks, by UUID, so that the order does not depend on the unordered proxy blocks
+of the module.
+
+Finding them from the blocks of the module, instead of filtering the vertices of the whole
+CFG with getCfgNodeModule, keeps the cost of a pass on one module independent of the
+number of modules in the IR.
+*/
+inline std::vector<gtirb::CFG::vertex_descriptor> getModuleCfgVertices(const gtirb::CFG& Cfg,
+                                                                       const gtirb::Module& Module)
+{
+    std::vector<gtirb::CFG::vertex_descriptor> Vertices;
+    for(const gtirb::CodeBlock& Block : Module.code_blocks())
+    {
+        if(auto Vertex = getCfgVertex(Cfg, &Block))
+        {
+            Vertices.push_back(*Vertex);
+        }
+    }
+    std::vector<const gtirb::ProxyBlock*> Proxies;
+    for(const gtirb::ProxyBlock& Proxy : Module.proxy_blocks())
+    {
+        Proxies.push_back(&Proxy);
+    }
+    std::sort(Proxies.begin(), Proxies.end(),
+              [](const gtirb::ProxyBlock* A, const gtirb::ProxyBlock* B) {
+                  return A->getUUID() < B->getUUID();
+              });
+    for(const gtirb::ProxyBlock* Proxy : Proxies)
+    {
+        if(auto Vertex = getCfgVertex(Cfg, Proxy))
+        {
+            Vertices.push_back(*Vertex);
+        }
+    }
+    return Vertices;
+}
+
+#endif // _CFG_UTILS_H_
@@ -22,13 +22,20 @@
 //===----------------------------------------------------------------------===//
 #include "CliDriver.h"
 
+#include <mutex>
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+#include "passes/DatalogAnalysisPass.h"
+
 // Define CLI output field widths
 constexpr size_t IndentWidth = 4;
 constexpr size_t TimeWidth = 8;
 constexpr size_t PassNameWidth = 18;
 constexpr size_t PassStepWidth = 12;
 
-void printElapsedTime(std::chrono::duration<double> Elapsed)
+void printElapsedTime(std::chrono::duration<double> Elapsed, std::ostream &Out)
 {
     auto Hours = std::chrono::duration_cast<std::chrono::hours>(Elapsed).count();
     auto Minutes = std::chrono::duration_cast<std::chrono::minutes>(Elapsed).count();
@@ -55,24 +62,78 @@ void printElapsedTime(std::chrono::duration<double> Elapsed)
     }
 
     // set width to TimeWidth-2; it includes the size of the brackets
-    std::cerr << "[" << std::right << std::setw(TimeWidth - 2) << FmttedDuration.str() << "]";
+    Out << "[" << std::right << std::setw(TimeWidth - 2) << FmttedDuration.str() << "]";
+}
+
+std::optional<uint64_t> getPeakMemoryUsage()
+{
+#if defined(__unix__) || defined(__APPLE__)
+    struct rusage Usage;
+    if(getrusage(RUSAGE_SELF, &Usage) == 0)
+    {
+#if defined(__APPLE__)
+        return static_cast<uint64_t>(Usage.ru_maxrss);
+#else
+        return static_cast<uint64_t>(Usage.ru_maxrss) * 1024;
+#endif
+    }
+#endif
+    return std::nullopt;
 }
 
-void printElapsedTimeSince(std::chrono::time_point<std::chrono::high_resolution_clock> Start)
+void printPeakMemoryUsage(std::ostream &Out)
+{
+    if(std::optional<uint64_t> Peak = getPeakMemoryUsage())
+    {
+        Out << " [peak memory " << (*Peak >> 20) << "MiB]";
+    }
+}
+
+std::optional<std::chrono::duration<double>> getProcessCpuTime()
+{
+#if defined(__unix__) || defined(__APPLE__)
+    struct rusage Usage;
+    if(getrusage(RUSAGE_SELF, &Usage) == 0)
+    {
+        return std::chrono::seconds(Usage.ru_utime.tv_sec + Usage.ru_stime.tv_sec)
+               + std::chrono::microseconds(Usage.ru_utime.tv_usec + Usage.ru_stime.tv_usec);
+    }
+#endif
+    return std::nullopt;
+}
+
+void printElapsedTimeSince(std::chrono::time_point<std::chrono::high_resolution_clock> Start,
+                           std::ostream &Out)
 {
     auto End = std::chrono::high_resolution_clock::now();
-    printElapsedTime(End - Start);
+    printElapsedTime(End - Start, Out);
+}
+
+void DDisasmPipelineListener::flush()
+{
+    if(!Buffered)
+    {
+        std::cerr << std::flush;
+        return;
+    }
+
+    // Listeners of concurrent pipelines share std::cerr.
+    static std::mutex OutputMutex;
+    std::lock_guard<std::mutex> Lock(OutputMutex);
+    std::cerr << Buffer.str() << std::flush;
+    Buffer.str("");
+    Buffer.clear();
 }
 
 void DDisasmPipelineListener::notifyPassBegin(const AnalysisPass &Pass)
 {
-    std::cerr << std::setw(IndentWidth) << "" << std::left << std::setw(PassNameWidth)
-              << Pass.getName() << std::flush;
+    stream() << std::setw(IndentWidth) << "" << std::left << std::setw(PassNameWidth)
+             << Pass.getName() << std::flush;
 }
 
 void DDisasmPipelineListener::notifyPassEnd([[maybe_unused]] const AnalysisPass &Pass)
 {
-    std::cerr << "\n";
+    stream() << "\n";
 }
 
 void DDisasmPipelineListener::notifyPassPhase(AnalysisPassPhase Phase, bool HasPhase)
@@ -92,34 +153,35 @@ void DDisasmPipelineListener::notifyPassPhase(AnalysisPassPhase Phase, bool HasP
     }
     if(HasPhase)
     {
-        std::cerr << std::right << std::setw(PassStepWidth) << (Name + " ");
+        stream() << std::right << std::setw(PassStepWidth) << (Name + " ");
     }
     else
     {
-        std::cerr << std::setw(PassStepWidth + TimeWidth) << "";
+        stream() << std::setw(PassStepWidth + TimeWidth) << "";
     }
-    std::cerr << std::flush;
+    stream() << std::flush;
 }
 
 void DDisasmPipelineListener::notifyPassResult(AnalysisPassPhase Phase,
                                                const AnalysisPassResult &Result)
 {
-    printElapsedTime(Result.RunTime);
+    printElapsedTime(Result.RunTime, stream());
     if(!Result.Warnings.empty() || !Result.Errors.empty())
     {
-        std::cerr << "\n";
+        stream() << "\n";
     }
     for(const std::string &Warning : Result.Warnings)
     {
-        std::cerr << "WARNING: " << Warning << "\n";
+        stream() << "WARNING: " << Warning << "\n";
     }
     for(const std::string &Error : Result.Errors)
     {
-        std::cerr << "ERROR: " << Error << "\n" << std::flush;
+        stream() << "ERROR: " << Error << "\n" << std::flush;
     }
     if(!Result.Errors.empty())
     {
-        std::exit(EXIT_FAILURE);
+        flush();
+        throw AnalysisPassError(Result.Errors.front());
     }
     if(!Result.Warnings.empty())
     {
@@ -138,8 +200,221 @@ void DDisasmPipelineListener::notifyPassResult(AnalysisPassPhase Phase,
         }
 
         // Re-indent after emitting warnings
-        std::cerr << std::setw(IndentWidth + PassNameWidth
-                               + PaddingMult * (PassStepWidth + TimeWidth))
-                  << "";
+        stream() << std::setw(IndentWidth + PassNameWidth
+                              + PaddingMult * (PassStepWidth + TimeWidth))
+                 << "";
+    }
+}
+
+size_t PipelineReport::addModule(const std::string &Name)
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    Modules.push_back({Name, {}});
+    return Modules.size() - 1;
+}
+
+void PipelineReport::addPass(size_t Index, Pass &&Entry)
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    Modules[Index].Passes.push_back(std::move(Entry));
+}
+
+static void writeJsonString(std::ostream &Out, const std::string &Str)
+{
+    Out << '"';
+    for(char C : Str)
+    {
+        switch(C)
+        {
+            case '"':
+                Out << "\\\"";
+                break;
+            case '\\':
+                Out << "\\\\";
+                break;
+            case '\n':
+                Out << "\\n";
+                break;
+            case '\t':
+                Out << "\\t";
+                break;
+            default:
+                if(static_cast<unsigned char>(C) < 0x20)
+                {
+                    Out << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+                        << static_cast<int>(C) << std::dec << std::setfill(' ');
+                }
+                else
+                {
+                    Out << C;
+                }
+        }
+    }
+    Out << '"';
+}
+
+static void writeJsonRelations(std::ostream &Out, const char *Name,
+                               const std::vector<std::pair<std::string, uint64_t>> &Relations)
+{
+    if(Relations.empty())
+    {
+        return;
+    }
+    Out << ", \"" << Name << "\": {";
+    for(size_t I = 0; I < Relations.size(); I++)
+    {
+        Out << (I ? ", " : "");
+        writeJsonString(Out, Relations[I].first);
+        Out << ": " << Relations[I].second;
+    }
+    Out << "}";
+}
+
+static void writeJsonPhase(std::ostream &Out, const char *Name, const PipelineReport::Phase &Phase)
+{
+    if(!Phase.Ran)
+    {
+        return;
+    }
+    Out << ", \"" << Name << "\": {\"wall_time\": " << Phase.WallTime.count()
+        << ", \"cpu_time\": " << Phase.CpuTime.count()
+        << ", \"peak_memory_delta\": " << Phase.PeakMemoryDelta << "}";
+}
+
+void PipelineReport::write(std::ostream &Out)
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    Out << "{\n  \"version\": ";
+    writeJsonString(Out, Version);
+    Out << ",\n  \"modules\": [";
+    for(size_t I = 0; I < Modules.size(); I++)
+    {
+        Out << (I ? ",\n" : "\n") << "    {\"name\": ";
+        writeJsonString(Out, Modules[I].Name);
+        Out << ", \"passes\": [";
+        for(size_t J = 0; J < Modules[I].Passes.size(); J++)
+        {
+            const Pass &Entry = Modules[I].Passes[J];
+            Out << (J ? ",\n" : "\n") << "      {\"name\": ";
+            writeJsonString(Out, Entry.Name);
+            Out << ", \"threads\": " << Entry.Threads;
+            writeJsonPhase(Out, "load", Entry.Load);
+            writeJsonPhase(Out, "compute", Entry.Analyze);
+            writeJsonPhase(Out, "transform", Entry.Transform);
+            if(Entry.InputTuples)
+            {
+                Out << ", \"input_tuples\": " << *Entry.InputTuples;
+            }
+            if(Entry.OutputTuples)
+            {
+                Out << ", \"output_tuples\": " << *Entry.OutputTuples;
+            }
+            writeJsonRelations(Out, "input_relations", Entry.InputRelations);
+            writeJsonRelations(Out, "output_relations", Entry.OutputRelations);
+            Out << "}";
+        }
+        Out << (Modules[I].Passes.empty() ? "]}" : "\n    ]}");
+    }
+    Out << (Modules.empty() ? "]\n}\n" : "\n  ]\n}\n");
+}
+
+// Total tuple count of Relations. The count of every relation is also appended to
+// Detail, if given.
+static uint64_t countTuples(const std::vector<souffle::Relation *> &Relations,
+                            std::vector<std::pair<std::string, uint64_t>> *Detail)
+{
+    uint64_t Count = 0;
+    for(souffle::Relation *Relation : Relations)
+    {
+        uint64_t Size = Relation->size();
+        if(Detail)
+        {
+            Detail->emplace_back(Relation->getName(), Size);
+        }
+        Count += Size;
+    }
+    return Count;
+}
+
+void ReportPipelineListener::notifyModuleBegin(const gtirb::Module &Module)
+{
+    ModuleIndex = Report->addModule(Module.getName());
+}
+
+void ReportPipelineListener::notifyPassBegin(const AnalysisPass &Pass)
+{
+    CurrentPass = &Pass;
+    Current = PipelineReport::Pass();
+    Current.Name = Pass.getName();
+    if(auto *DatalogPass = dynamic_cast<const DatalogAnalysisPass *>(&Pass))
+    {
+        Current.Threads = DatalogPass->getThreadCount();
+    }
+}
+
+void ReportPipelineListener::notifyPassEnd([[maybe_unused]] const AnalysisPass &Pass)
+{
+    Report->addPass(ModuleIndex, std::move(Current));
+    CurrentPass = nullptr;
+}
+
+PipelineReport::Phase &ReportPipelineListener::phase(AnalysisPassPhase Phase)
+{
+    switch(Phase)
+    {
+        case AnalysisPassPhase::LOAD:
+            return Current.Load;
+        case AnalysisPassPhase::ANALYZE:
+            return Current.Analyze;
+        case AnalysisPassPhase::TRANSFORM:
+        default:
+            return Current.Transform;
+    }
+}
+
+void ReportPipelineListener::notifyPassPhase(AnalysisPassPhase Phase, bool HasPhase)
+{
+    if(!HasPhase)
+    {
+        return;
+    }
+
+    // The facts of a Datalog pass are complete, hints included, once its analysis starts.
+    if(Phase == AnalysisPassPhase::ANALYZE)
+    {
+        auto *DatalogPass = dynamic_cast<const DatalogAnalysisPass *>(CurrentPass);
+        if(const souffle::SouffleProgram *Program =
+               DatalogPass ? DatalogPass->getLoadedProgram() : nullptr)
+        {
+            Current.InputTuples =
+                countTuples(Program->getInputRelations(),
+                            Report->hasRelationDetail() ? &Current.InputRelations : nullptr);
+        }
+    }
+
+    StartCpuTime = getProcessCpuTime().value_or(std::chrono::duration<double>(0));
+    StartPeakMemory = getPeakMemoryUsage().value_or(0);
+}
+
+void ReportPipelineListener::notifyPassResult(AnalysisPassPhase Phase,
+                                              const AnalysisPassResult &Result)
+{
+    PipelineReport::Phase &Entry = phase(Phase);
+    Entry.Ran = true;
+    Entry.WallTime = Result.RunTime;
+    Entry.CpuTime =
+        getProcessCpuTime().value_or(std::chrono::duration<double>(0)) - StartCpuTime;
+    Entry.PeakMemoryDelta = getPeakMemoryUsage().value_or(0) - StartPeakMemory;
+
+    if(Phase == AnalysisPassPhase::ANALYZE)
+    {
+        auto *DatalogPass = dynamic_cast<const DatalogAnalysisPass *>(CurrentPass);
+        if(const souffle::SouffleProgram *Program =
+               DatalogPass ? DatalogPass->getLoadedProgram() : nullptr)
+        {
+            Current.OutputTuples =
+                countTuples(Program->getOutputRelations(),
+                            Report->hasRelationDetail() ? &Current.OutputRelations : nullptr);
+        }
     }
 }
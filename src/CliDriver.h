@@ -25,25 +25,178 @@
 
 #include <chrono>
 #include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <sstream>
+#include <string>
+#include <vector>
 
 #include "AnalysisPipeline.h"
 #include "passes/AnalysisPass.h"
 
-void printElapsedTime(std::chrono::duration<double> Elapsed);
-void printElapsedTimeSince(std::chrono::time_point<std::chrono::high_resolution_clock> Start);
+void printElapsedTime(std::chrono::duration<double> Elapsed, std::ostream& Out = std::cerr);
+void printElapsedTimeSince(std::chrono::time_point<std::chrono::high_resolution_clock> Start,
+                           std::ostream& Out = std::cerr);
 bool printPassResults(const AnalysisPassResult& Result);
 
+/**
+Peak resident set size of the process in bytes, if the platform reports it.
+*/
+std::optional<uint64_t> getPeakMemoryUsage();
+void printPeakMemoryUsage(std::ostream& Out = std::cerr);
+
+/**
+User and system CPU time consumed by all threads of the process so far, if the
+platform reports it.
+*/
+std::optional<std::chrono::duration<double>> getProcessCpuTime();
+
+/**
+Thrown by DDisasmPipelineListener when a pass reports errors, so that ddisasm exits from the
+main thread once all module workers have stopped, rather than from a worker.
+*/
+class AnalysisPassError : public std::runtime_error
+{
+public:
+    using std::runtime_error::runtime_error;
+};
+
 class DDisasmPipelineListener : public AnalysisPipelineListener
 {
 public:
+    /**
+    A buffered listener keeps its report until flush() is called, so that the
+    report of a module is printed as one block when several modules are
+    processed concurrently.
+    */
+    DDisasmPipelineListener(bool Buffered = false) : Buffered(Buffered)
+    {
+    }
+
     virtual ~DDisasmPipelineListener()
     {
     }
 
+    /**
+    Stream the listener reports to.
+    */
+    std::ostream& stream()
+    {
+        return Buffered ? Buffer : std::cerr;
+    }
+
+    /**
+    Write the buffered report to std::cerr.
+    */
+    void flush();
+
     virtual void notifyPassBegin(const AnalysisPass& Pass);
     virtual void notifyPassEnd(const AnalysisPass& Pass);
     virtual void notifyPassPhase(AnalysisPassPhase Phase, bool HasPhase);
     virtual void notifyPassResult(AnalysisPassPhase Phase, const AnalysisPassResult& Result);
+
+private:
+    bool Buffered;
+    std::stringstream Buffer;
+};
+
+/**
+Machine-readable record of the passes run on every module, written as JSON.
+
+A single report is shared by the ReportPipelineListener of every module worker.
+*/
+class PipelineReport
+{
+public:
+    struct Phase
+    {
+        bool Ran = false;
+        std::chrono::duration<double> WallTime{0};
+        std::chrono::duration<double> CpuTime{0};
+        uint64_t PeakMemoryDelta = 0;
+    };
+
+    struct Pass
+    {
+        std::string Name;
+        unsigned int Threads = 1;
+        Phase Load;
+        Phase Analyze;
+        Phase Transform;
+        std::optional<uint64_t> InputTuples;
+        std::optional<uint64_t> OutputTuples;
+        std::vector<std::pair<std::string, uint64_t>> InputRelations;
+        std::vector<std::pair<std::string, uint64_t>> OutputRelations;
+    };
+
+    /**
+    With RelationDetail, Datalog passes also record the tuple count of every
+    input and output relation, not only the totals.
+    */
+    PipelineReport(const std::string& Version, bool RelationDetail = false)
+        : Version(Version), RelationDetail(RelationDetail)
+    {
+    }
+
+    bool hasRelationDetail() const
+    {
+        return RelationDetail;
+    }
+
+    /**
+    Start a new module entry and return its index.
+    */
+    size_t addModule(const std::string& Name);
+    void addPass(size_t Index, Pass&& Entry);
+
+    void write(std::ostream& Out);
+
+private:
+    struct Module
+    {
+        std::string Name;
+        std::vector<Pass> Passes;
+    };
+
+    std::mutex Mutex;
+    std::string Version;
+    bool RelationDetail;
+    std::vector<Module> Modules;
+};
+
+/**
+Listener that measures every phase of a pipeline and records it in a
+PipelineReport.
+
+CPU time and peak memory are sampled for the whole process, so phases of
+modules analyzed concurrently include each other's usage.
+*/
+class ReportPipelineListener : public AnalysisPipelineListener
+{
+public:
+    ReportPipelineListener(std::shared_ptr<PipelineReport> Report) : Report(Report)
+    {
+    }
+
+    virtual void notifyModuleBegin(const gtirb::Module& Module) override;
+    virtual void notifyPassBegin(const AnalysisPass& Pass) override;
+    virtual void notifyPassEnd(const AnalysisPass& Pass) override;
+    virtual void notifyPassPhase(AnalysisPassPhase Phase, bool HasPhase) override;
+    virtual void notifyPassResult(AnalysisPassPhase Phase,
+                                  const AnalysisPassResult& Result) override;
+
+private:
+    PipelineReport::Phase& phase(AnalysisPassPhase Phase);
+
+    std::shared_ptr<PipelineReport> Report;
+    size_t ModuleIndex = 0;
+    const AnalysisPass* CurrentPass = nullptr;
+    PipelineReport::Pass Current;
+    std::chrono::duration<double> StartCpuTime{0};
+    uint64_t StartPeakMemory = 0;
 };
 
 #endif /* _CLI_DRIVER_H_ */
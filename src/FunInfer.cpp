@@ -181,7 +181,15 @@ int main(int argc, char **argv)
     for(auto &Module : Modules)
     {
         std::cerr << "Processing module: " << Module.getName() << "\n";
-        Pipeline.run(Context, Module);
+        try
+        {
+            Pipeline.run(Context, Module);
+        }
+        catch(const AnalysisPassError &)
+        {
+            // The errors have been reported by the pipeline listener.
+            return EXIT_FAILURE;
+        }
     }
 
     // Output GTIRB
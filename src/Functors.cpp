@@ -22,9 +22,14 @@
 //===----------------------------------------------------------------------===//
 #include "Functors.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <cstdlib>
 #include <fstream>
 #include <iostream>
+#include <mutex>
+#include <stdexcept>
 
 #include "Endian.h"
 
@@ -49,149 +54,368 @@ namespace
         return Signed;
     }
 
+    static inline bool isDataSection(const gtirb::Section& Section)
+    {
+        bool Executable = Section.isFlagSet(gtirb::SectionFlag::Executable);
+        bool Initialized = Section.isFlagSet(gtirb::SectionFlag::Initialized);
+        bool Loaded = Section.isFlagSet(gtirb::SectionFlag::Loaded);
+        return Loaded && (Executable || Initialized);
+    }
+
+    static inline FunctorDataRange makeRange(const gtirb::ByteInterval& ByteInterval)
+    {
+        uint64_t Begin = static_cast<uint64_t>(*ByteInterval.getAddress());
+        return {Begin, Begin + ByteInterval.getInitializedSize(),
+                ByteInterval.rawBytes<const uint8_t>(), &ByteInterval};
+    }
+
+    // Index generations are unique across contexts, so a cached range is never
+    // used with a different index.
+    std::atomic<uint64_t> NextGeneration(1);
+
+    struct LookupCache
+    {
+        uint64_t Generation = 0;
+        FunctorDataRange Range;
+    };
+
+    // Consecutive functor calls tend to read the same byte interval.
+    thread_local LookupCache LastHit;
+
 } // namespace
 
 FunctorContextManager FunctorContext;
 
-const gtirb::ByteInterval* FunctorContextManager::getByteInterval(uint64_t EA, size_t Size)
+bool FunctorContextManager::findRange(uint64_t EA, size_t Size, FunctorDataRange& Range) const
 {
-    for(const auto& Section : Module->findSectionsOn(gtirb::Addr(EA)))
+    if(!Overlapping && LastHit.Generation == Generation && LastHit.Range.Begin <= EA
+       && EA + Size <= LastHit.Range.End)
     {
-        bool Executable = Section.isFlagSet(gtirb::SectionFlag::Executable);
-        bool Initialized = Section.isFlagSet(gtirb::SectionFlag::Initialized);
-        bool Loaded = Section.isFlagSet(gtirb::SectionFlag::Loaded);
-        if(Loaded && (Executable || Initialized))
+        Range = LastHit.Range;
+        return true;
+    }
+
+    if(Overlapping)
+    {
+        // Resolve overlapping ranges in the order of the module lookup.
+        const gtirb::ByteInterval* Found = nullptr;
+        for(const auto& Section : Module->findSectionsOn(gtirb::Addr(EA)))
         {
+            if(!isDataSection(Section))
+            {
+                continue;
+            }
             for(const auto& ByteInterval : Section.findByteIntervalsOn(gtirb::Addr(EA)))
             {
                 uint64_t Addr = static_cast<uint64_t>(*ByteInterval.getAddress());
-                uint64_t IntervalSize = ByteInterval.getInitializedSize();
-                if(EA + Size > Addr + IntervalSize)
+                if(EA + Size <= Addr + ByteInterval.getInitializedSize())
                 {
-                    continue;
+                    Found = &ByteInterval;
+                    break;
                 }
-                return &ByteInterval;
             }
+            if(Found)
+            {
+                break;
+            }
+        }
+        if(!Found)
+        {
+            return false;
+        }
+        Range = makeRange(*Found);
+    }
+    else
+    {
+        // Branch-free binary search for the last range starting at or before EA.
+        size_t Count = RangeBegins.size();
+        if(Count == 0)
+        {
+            return false;
+        }
+        const uint64_t* Base = RangeBegins.data();
+        while(Count > 1)
+        {
+            size_t Half = Count / 2;
+            Base = Base[Half] <= EA ? Base + Half : Base;
+            Count -= Half;
         }
+        const FunctorDataRange& Found = Ranges[Base - RangeBegins.data()];
+        if(Found.Begin > EA || EA + Size > Found.End)
+        {
+            return false;
+        }
+        Range = Found;
     }
-    return nullptr;
+
+    LastHit = {Generation, Range};
+    return true;
 }
 
-uint64_t functor_data_valid(uint64_t EA, size_t Size)
+const gtirb::ByteInterval* FunctorContextManager::getByteInterval(uint64_t EA, size_t Size) const
 {
-    if(!(Size == 1 || Size == 2 || Size == 4 || Size == 8))
-    {
-        return 0;
-    }
-    const gtirb::ByteInterval* ByteInterval = FunctorContext.getByteInterval(EA, Size);
-    return ByteInterval != nullptr ? 1 : 0;
+    FunctorDataRange Range;
+    return findRange(EA, Size, Range) ? Range.ByteInterval : nullptr;
 }
 
-void FunctorContextManager::readData(uint64_t EA, uint8_t* Buffer, size_t Count)
+void FunctorContextManager::readData(uint64_t EA, uint8_t* Buffer, size_t Count) const
 {
-    const gtirb::ByteInterval* ByteInterval = FunctorContext.getByteInterval(EA, Count);
-    if(ByteInterval == nullptr)
+    FunctorDataRange Range;
+    if(!findRange(EA, Count, Range))
     {
         memset(Buffer, 0, Count);
         return;
     }
-    uint64_t Addr = static_cast<uint64_t>(*ByteInterval->getAddress());
-    auto Data = ByteInterval->rawBytes<const uint8_t>();
 
     // memcpy: safely handles unaligned requests.
-    memcpy(Buffer, Data + EA - Addr, Count);
+    memcpy(Buffer, Range.Data + EA - Range.Begin, Count);
 }
 
-uint64_t functor_data_unsigned(uint64_t EA, size_t Size)
+uint64_t FunctorContextManager::readUnsigned(uint64_t EA, size_t Size) const
 {
     switch(Size)
     {
         case 1:
-            return functor_data_u8(EA);
+        {
+            uint8_t Value;
+            readData(EA, reinterpret_cast<uint8_t*>(&Value), sizeof(Value));
+            return Value;
+        }
         case 2:
-            return functor_data_u16(EA);
+        {
+            uint16_t Value;
+            readData(EA, reinterpret_cast<uint8_t*>(&Value), sizeof(Value));
+            return IsBigEndian ? be16toh(Value) : le16toh(Value);
+        }
         case 4:
-            return functor_data_u32(EA);
+        {
+            uint32_t Value;
+            readData(EA, reinterpret_cast<uint8_t*>(&Value), sizeof(Value));
+            return IsBigEndian ? be32toh(Value) : le32toh(Value);
+        }
         case 8:
-            return functor_data_u64(EA);
+        {
+            uint64_t Value;
+            readData(EA, reinterpret_cast<uint8_t*>(&Value), sizeof(Value));
+            return IsBigEndian ? be64toh(Value) : le64toh(Value);
+        }
         default:
             assert(!"Invalid size");
     }
     return 0;
 }
 
-uint64_t functor_data_u8(uint64_t EA)
+int64_t FunctorContextManager::readSigned(uint64_t EA, size_t Size) const
 {
-    uint8_t Value;
-    FunctorContext.readData(EA, reinterpret_cast<uint8_t*>(&Value), sizeof(Value));
-    return Value;
+    switch(Size)
+    {
+        case 1:
+            return static_cast<int8_t>(readUnsigned(EA, Size));
+        case 2:
+            return static_cast<int16_t>(readUnsigned(EA, Size));
+        case 4:
+            return static_cast<int32_t>(readUnsigned(EA, Size));
+        case 8:
+            return static_cast<int64_t>(readUnsigned(EA, Size));
+        default:
+            assert(!"Invalid size");
+    }
+    return 0;
 }
 
-uint64_t functor_data_u16(uint64_t EA)
+namespace
+{
+    /*
+    Registered functor contexts.
+
+    Registration and removal are serialized by a mutex, but lookups only use
+    atomic loads. A slot's Generation changes whenever the slot is registered
+    or released, which invalidates the per-thread caches of lookups.
+    */
+    constexpr size_t MaxFunctorContexts = 1024;
+
+    struct FunctorContextSlot
+    {
+        std::atomic<const souffle::SymbolTable*> SymbolTable{nullptr};
+        std::atomic<const FunctorContextManager*> Context{nullptr};
+        std::atomic<uint64_t> Generation{0};
+    };
+
+    FunctorContextSlot FunctorContextSlots[MaxFunctorContexts];
+    std::mutex FunctorContextMutex;
+
+    struct FunctorContextCache
+    {
+        const souffle::SymbolTable* SymbolTable = nullptr;
+        size_t Slot = 0;
+        uint64_t Generation = 0;
+        const FunctorContextManager* Context = nullptr;
+    };
+
+    thread_local FunctorContextCache LastContext;
+} // namespace
+
+FunctorContextRegistration::FunctorContextRegistration(const souffle::SymbolTable& SymbolTable,
+                                                       const gtirb::Module& Module)
+    : Context(std::make_unique<FunctorContextManager>())
+{
+    Context->useModule(&Module);
+
+    std::lock_guard<std::mutex> Lock(FunctorContextMutex);
+    for(Slot = 0; Slot < MaxFunctorContexts; Slot++)
+    {
+        if(FunctorContextSlots[Slot].SymbolTable.load(std::memory_order_relaxed) == nullptr)
+        {
+            break;
+        }
+    }
+    if(Slot == MaxFunctorContexts)
+    {
+        throw std::runtime_error("Too many functor contexts");
+    }
+
+    FunctorContextSlot& Entry = FunctorContextSlots[Slot];
+    Entry.Context.store(Context.get(), std::memory_order_relaxed);
+    Entry.Generation.fetch_add(1, std::memory_order_release);
+    Entry.SymbolTable.store(&SymbolTable, std::memory_order_release);
+}
+
+FunctorContextRegistration::~FunctorContextRegistration()
 {
-    uint16_t Value;
-    FunctorContext.readData(EA, reinterpret_cast<uint8_t*>(&Value), sizeof(Value));
-    return FunctorContext.IsBigEndian ? be16toh(Value) : le16toh(Value);
+    std::lock_guard<std::mutex> Lock(FunctorContextMutex);
+    FunctorContextSlot& Entry = FunctorContextSlots[Slot];
+    Entry.SymbolTable.store(nullptr, std::memory_order_release);
+    Entry.Generation.fetch_add(1, std::memory_order_release);
+    Entry.Context.store(nullptr, std::memory_order_relaxed);
 }
 
-uint64_t functor_data_u32(uint64_t EA)
+[[noreturn]] static void reportMissingFunctorContext()
 {
-    uint32_t Value;
-    FunctorContext.readData(EA, reinterpret_cast<uint8_t*>(&Value), sizeof(Value));
-    return FunctorContext.IsBigEndian ? be32toh(Value) : le32toh(Value);
+    // Reading no data would silently change the results, so fail in every build.
+    std::cerr << "Error: data functors called by a Souffle program without a registered "
+                 "functor context\n";
+    std::abort();
 }
 
-uint64_t functor_data_u64(uint64_t EA)
+static const FunctorContextManager& getDefaultFunctorContext()
 {
-    uint64_t Value;
-    FunctorContext.readData(EA, reinterpret_cast<uint8_t*>(&Value), sizeof(Value));
-    return FunctorContext.IsBigEndian ? be64toh(Value) : le64toh(Value);
+    if(!FunctorContext.hasModule())
+    {
+        reportMissingFunctorContext();
+    }
+    return FunctorContext;
 }
 
-int64_t functor_data_signed(uint64_t EA, size_t Size)
+const FunctorContextManager& getFunctorContext(const souffle::SymbolTable* SymbolTable)
 {
-    switch(Size)
+    if(SymbolTable == nullptr)
     {
-        case 1:
-            return functor_data_s8(EA);
-        case 2:
-            return functor_data_s16(EA);
-        case 4:
-            return functor_data_s32(EA);
-        case 8:
-            return functor_data_s64(EA);
-        default:
-            assert(!"Invalid size");
+        return getDefaultFunctorContext();
     }
-    return 0;
+
+    FunctorContextCache& Cache = LastContext;
+    if(Cache.SymbolTable == SymbolTable
+       && FunctorContextSlots[Cache.Slot].Generation.load(std::memory_order_acquire)
+              == Cache.Generation)
+    {
+        return *Cache.Context;
+    }
+
+    for(size_t Slot = 0; Slot < MaxFunctorContexts; Slot++)
+    {
+        FunctorContextSlot& Entry = FunctorContextSlots[Slot];
+        if(Entry.SymbolTable.load(std::memory_order_acquire) == SymbolTable)
+        {
+            uint64_t Generation = Entry.Generation.load(std::memory_order_acquire);
+            const FunctorContextManager* Context = Entry.Context.load(std::memory_order_relaxed);
+            Cache = {SymbolTable, Slot, Generation, Context};
+            return *Context;
+        }
+    }
+#ifdef __EMBEDDED_SOUFFLE__
+    // Synthesized programs always register their context.
+    reportMissingFunctorContext();
+#else
+    return getDefaultFunctorContext();
+#endif /* __EMBEDDED_SOUFFLE__ */
+}
+
+static inline bool isValidSize(uint64_t Size)
+{
+    return Size == 1 || Size == 2 || Size == 4 || Size == 8;
+}
+
+souffle::RamDomain functor_data_valid(souffle::SymbolTable* symbolTable,
+                                      [[maybe_unused]] souffle::RecordTable* recordTable,
+                                      souffle::RamDomain EA, souffle::RamDomain Size)
+{
+    uint64_t Addr = souffle::ramBitCast<souffle::RamUnsigned>(EA);
+    uint64_t Count = souffle::ramBitCast<souffle::RamUnsigned>(Size);
+    if(!isValidSize(Count))
+    {
+        return 0;
+    }
+    return getFunctorContext(symbolTable).getByteInterval(Addr, Count) != nullptr ? 1 : 0;
+}
+
+souffle::RamDomain functor_data_unsigned(souffle::SymbolTable* symbolTable,
+                                         [[maybe_unused]] souffle::RecordTable* recordTable,
+                                         souffle::RamDomain EA, souffle::RamDomain Size)
+{
+    uint64_t Addr = souffle::ramBitCast<souffle::RamUnsigned>(EA);
+    uint64_t Count = souffle::ramBitCast<souffle::RamUnsigned>(Size);
+    uint64_t Value = getFunctorContext(symbolTable).readUnsigned(Addr, Count);
+    return souffle::ramBitCast(static_cast<souffle::RamUnsigned>(Value));
+}
+
+souffle::RamDomain functor_data_signed(souffle::SymbolTable* symbolTable,
+                                       [[maybe_unused]] souffle::RecordTable* recordTable,
+                                       souffle::RamDomain EA, souffle::RamDomain Size)
+{
+    uint64_t Addr = souffle::ramBitCast<souffle::RamUnsigned>(EA);
+    uint64_t Count = souffle::ramBitCast<souffle::RamUnsigned>(Size);
+    int64_t Value = getFunctorContext(symbolTable).readSigned(Addr, Count);
+    return souffle::ramBitCast(static_cast<souffle::RamSigned>(Value));
+}
+
+uint64_t functor_data_u8(uint64_t EA)
+{
+    return FunctorContext.readUnsigned(EA, 1);
+}
+
+uint64_t functor_data_u16(uint64_t EA)
+{
+    return FunctorContext.readUnsigned(EA, 2);
+}
+
+uint64_t functor_data_u32(uint64_t EA)
+{
+    return FunctorContext.readUnsigned(EA, 4);
+}
+
+uint64_t functor_data_u64(uint64_t EA)
+{
+    return FunctorContext.readUnsigned(EA, 8);
 }
 
 int64_t functor_data_s8(uint64_t EA)
 {
-    uint8_t Value;
-    FunctorContext.readData(EA, reinterpret_cast<uint8_t*>(&Value), sizeof(Value));
-    return static_cast<int8_t>(Value);
+    return FunctorContext.readSigned(EA, 1);
 }
 
 int64_t functor_data_s16(uint64_t EA)
 {
-    uint16_t Value;
-    FunctorContext.readData(EA, reinterpret_cast<uint8_t*>(&Value), sizeof(Value));
-    return static_cast<int16_t>(FunctorContext.IsBigEndian ? be16toh(Value) : le16toh(Value));
+    return FunctorContext.readSigned(EA, 2);
 }
 
 int64_t functor_data_s32(uint64_t EA)
 {
-    uint32_t Value;
-    FunctorContext.readData(EA, reinterpret_cast<uint8_t*>(&Value), sizeof(Value));
-    return static_cast<int32_t>(FunctorContext.IsBigEndian ? be32toh(Value) : le32toh(Value));
+    return FunctorContext.readSigned(EA, 4);
 }
 
 int64_t functor_data_s64(uint64_t EA)
 {
-    uint64_t Value;
-    FunctorContext.readData(EA, reinterpret_cast<uint8_t*>(&Value), sizeof(Value));
-    return static_cast<int64_t>(FunctorContext.IsBigEndian ? be64toh(Value) : le64toh(Value));
+    return FunctorContext.readSigned(EA, 8);
 }
 
 uint64_t functor_aligned(uint64_t EA, size_t Size)
@@ -242,6 +466,38 @@ void FunctorContextManager::useModule(const gtirb::Module* M)
 {
     Module = M;
 
+    // Index the initialized bytes of the data sections.
+    Ranges.clear();
+    for(const auto& Section : Module->sections())
+    {
+        if(!isDataSection(Section))
+        {
+            continue;
+        }
+        for(const auto& ByteInterval : Section.byte_intervals())
+        {
+            if(ByteInterval.getAddress() && ByteInterval.getInitializedSize() > 0)
+            {
+                Ranges.push_back(makeRange(ByteInterval));
+            }
+        }
+    }
+    std::stable_sort(Ranges.begin(), Ranges.end(),
+                     [](const FunctorDataRange& A, const FunctorDataRange& B) {
+                         return A.Begin < B.Begin;
+                     });
+
+    RangeBegins.clear();
+    Overlapping = false;
+    uint64_t End = 0;
+    for(const FunctorDataRange& Range : Ranges)
+    {
+        Overlapping |= !RangeBegins.empty() && Range.Begin < End;
+        End = std::max(End, Range.End);
+        RangeBegins.push_back(Range.Begin);
+    }
+    Generation = NextGeneration++;
+
     // Check module's byte order
     switch(Module->getByteOrder())
     {
@@ -302,6 +558,6 @@ void FunctorContextManager::loadGtirb(void)
         return;
     }
 
-    FunctorContext.useModule(&(*Modules.begin()));
+    useModule(&(*Modules.begin()));
 }
 #endif /* __EMBEDDED_SOUFFLE__ */
@@ -23,6 +23,8 @@
 #ifndef SRC_FUNCTORS_H_
 #define SRC_FUNCTORS_H_
 #include <gtirb/gtirb.hpp>
+#include <memory>
+#include <vector>
 
 #include "souffle/SouffleInterface.h"
 
@@ -45,15 +47,29 @@
 // C interface is used for accessing the functors from datalog
 extern "C"
 {
-    EXPORT uint64_t functor_data_valid(uint64_t EA, size_t Size);
+    /**
+    Data functors called from Datalog.
 
-    EXPORT uint64_t functor_data_unsigned(uint64_t EA, size_t Size);
+    They are stateful so that they receive the symbol table of the calling
+    program, which selects the functor context registered for the program.
+    */
+    EXPORT souffle::RamDomain functor_data_valid(souffle::SymbolTable* symbolTable,
+                                                 souffle::RecordTable* recordTable,
+                                                 souffle::RamDomain EA, souffle::RamDomain Size);
+    EXPORT souffle::RamDomain functor_data_unsigned(souffle::SymbolTable* symbolTable,
+                                                    souffle::RecordTable* recordTable,
+                                                    souffle::RamDomain EA,
+                                                    souffle::RamDomain Size);
+    EXPORT souffle::RamDomain functor_data_signed(souffle::SymbolTable* symbolTable,
+                                                  souffle::RecordTable* recordTable,
+                                                  souffle::RamDomain EA, souffle::RamDomain Size);
+
+    // Read data from the default FunctorContext.
     EXPORT uint64_t functor_data_u8(uint64_t EA);
     EXPORT uint64_t functor_data_u16(uint64_t EA);
     EXPORT uint64_t functor_data_u32(uint64_t EA);
     EXPORT uint64_t functor_data_u64(uint64_t EA);
 
-    EXPORT int64_t functor_data_signed(uint64_t EA, size_t Size);
     EXPORT int64_t functor_data_s8(uint64_t EA);
     EXPORT int64_t functor_data_s16(uint64_t EA);
     EXPORT int64_t functor_data_s32(uint64_t EA);
@@ -73,6 +89,24 @@ extern "C"
                                             souffle::RamDomain Value);
 }
 
+/**
+Address range of the initialized bytes of a byte interval visible to the data
+functors.
+*/
+struct FunctorDataRange
+{
+    uint64_t Begin = 0;
+    uint64_t End = 0;
+    const uint8_t* Data = nullptr;
+    const gtirb::ByteInterval* ByteInterval = nullptr;
+};
+
+/**
+The data of a module read by the data functors.
+
+A context is immutable once useModule() returns, so any number of threads can
+read from it concurrently.
+*/
 class FunctorContextManager
 {
 public:
@@ -88,20 +122,89 @@ public:
     }
 #endif /* __EMBEDDED_SOUFFLE__ */
 
-    const gtirb::ByteInterval* getByteInterval(uint64_t EA, size_t Size);
-    void readData(uint64_t EA, uint8_t* Buffer, size_t Count);
+    const gtirb::ByteInterval* getByteInterval(uint64_t EA, size_t Size) const;
+    void readData(uint64_t EA, uint8_t* Buffer, size_t Count) const;
+    uint64_t readUnsigned(uint64_t EA, size_t Size) const;
+    int64_t readSigned(uint64_t EA, size_t Size) const;
+
+    /**
+    Select the module read by the data functors and index its data.
+
+    The module must not be modified while the functors are in use.
+    */
     void useModule(const gtirb::Module* M);
+
+    /**
+    Whether useModule() selected a module.
+    */
+    bool hasModule() const
+    {
+        return Module != nullptr;
+    }
+
     bool IsBigEndian = false;
 
 private:
+    /**
+    Find the range that contains [EA, EA+Size).
+    */
+    bool findRange(uint64_t EA, size_t Size, FunctorDataRange& Range) const;
+
     const gtirb::Module* Module = nullptr;
 
+    // Ranges of the loaded, executable or initialized sections sorted by
+    // address, and their start addresses for the search.
+    std::vector<FunctorDataRange> Ranges;
+    std::vector<uint64_t> RangeBegins;
+
+    // Whether any ranges overlap, in which case lookups fall back to
+    // searching the module.
+    bool Overlapping = false;
+
+    // Identifies the current index for the lookup cache.
+    uint64_t Generation = 0;
+
 #ifndef __EMBEDDED_SOUFFLE__
     void loadGtirb(void);
     std::unique_ptr<gtirb::Context> GtirbContext;
 #endif
 };
 
+/**
+Default context, used by programs without a registered context, such as the
+Souffle interpreter.
+*/
 extern FunctorContextManager FunctorContext;
 
+/**
+Registers the functor context of a Souffle program while it is alive.
+
+The data functors find the context of the calling program from its symbol
+table. The lookup is lock-free, so the worker threads of several programs can
+call the functors concurrently. The registration must outlive the execution of
+the program.
+*/
+class FunctorContextRegistration
+{
+public:
+    FunctorContextRegistration(const souffle::SymbolTable& SymbolTable,
+                               const gtirb::Module& Module);
+    ~FunctorContextRegistration();
+
+    FunctorContextRegistration(const FunctorContextRegistration&) = delete;
+    FunctorContextRegistration& operator=(const FunctorContextRegistration&) = delete;
+
+private:
+    size_t Slot;
+    std::unique_ptr<FunctorContextManager> Context;
+};
+
+/**
+Get the context registered for a program's symbol table, or the default one.
+
+Synthesized programs must register their context, and the default one must have a module:
+otherwise an error is reported and ddisasm aborts, rather than silently reading no data.
+*/
+const FunctorContextManager& getFunctorContext(const souffle::SymbolTable* SymbolTable);
+
 #endif // SRC_FUNCTORS_H_
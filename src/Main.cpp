@@ -22,9 +22,12 @@
 //===----------------------------------------------------------------------===//
 #include <fcntl.h>
 
+#include <algorithm>
 #include <chrono>
 #include <iomanip>
 #include <iostream>
+#include <memory>
+#include <optional>
 #include <string>
 #include <thread>
 #include <vector>
@@ -49,8 +52,11 @@
 #include "AuxDataSchema.h"
 #include "CliDriver.h"
 #include "Hints.h"
+#include "ModuleScheduler.h"
 #include "Registration.h"
+#include "ResultCache.h"
 #include "Version.h"
+#include "gtirb-builder/ArchiveReader.h"
 #include "gtirb-builder/GtirbBuilder.h"
 #include "passes/DisassemblyPass.h"
 #include "passes/FunctionInferencePass.h"
@@ -123,6 +129,136 @@ static void checkOutputParamIsWritable(const po::variables_map &Vars, const std:
     }
 }
 
+// Pretty-print a single module to the `--asm' destination.
+static void printModule(const po::variables_map &vm, gtirb_pprint::PrettyPrinter &pprinter,
+                        gtirb::Context &Context, gtirb::Module &Module, bool MultipleModules)
+{
+    std::string ListingMode = vm.count("debug") != 0 ? "debug" : "";
+    const std::string &format = gtirb_pprint::getModuleFileFormat(Module);
+    const std::string &isa = gtirb_pprint::getModuleISA(Module);
+    const std::string &syntax =
+        gtirb_pprint::getDefaultSyntax(format, isa, ListingMode).value_or("");
+    auto target = std::make_tuple(format, isa, syntax);
+    pprinter.setTarget(std::move(target));
+
+    // Apply pre-print transforms provided by the pretty-printer library.
+    // This MODIFIES the GTIRB, so it's important to do this *after*
+    // writing the GTIRB output to disk if we're doing both.
+    gtirb_pprint::applyFixups(Context, Module, pprinter);
+
+    if(vm.count("debug") != 0)
+    {
+        pprinter.setListingMode("debug");
+    }
+
+    if(vm.count("keep-functions") != 0)
+    {
+        for(auto keep : vm["keep-functions"].as<std::vector<std::string>>())
+        {
+            pprinter.symbolPolicy().keep(keep);
+        }
+    }
+
+    fs::path AsmPath;
+    std::ofstream AsmFileStream;
+    bool UseStdout = true;
+    if(vm.count("asm") != 0)
+    {
+        std::string name = vm["asm"].as<std::string>();
+        if(name != "-")
+        {
+            AsmPath = name;
+        }
+    }
+
+    if(!AsmPath.empty())
+    {
+        // If there are multiple modules, use the asm argument as a directory.
+        // Each module will get its own .s file.
+        if(MultipleModules)
+        {
+            fs::create_directories(AsmPath);
+            std::string name = Module.getName();
+
+            // Strip ".o" extension if it exists.
+            if(name.compare(name.size() - 2, 2, ".o") == 0)
+            {
+                name.erase(name.size() - 2);
+            }
+            AsmPath /= name + ".s";
+        }
+        AsmFileStream.open(AsmPath.string());
+        UseStdout = false;
+    }
+
+    std::cerr << "Printing assembler " << std::flush;
+    auto StartPrinting = std::chrono::high_resolution_clock::now();
+    pprinter.print(UseStdout ? std::cout : AsmFileStream, Context, Module);
+    printElapsedTimeSince(StartPrinting);
+    std::cerr << "\n";
+}
+
+// Write the pass report requested with `--report'.
+static void writeReport(const po::variables_map &vm, PipelineReport *Report)
+{
+    if(Report)
+    {
+        std::ofstream Out(vm["report"].as<std::string>());
+        Report->write(Out);
+    }
+}
+
+// Create the cache for `--cache-dir', keyed by everything that determines the
+// GTIRB produced for Filename, or return nullptr if this run is not cacheable.
+static std::unique_ptr<ResultCache> createResultCache(const po::variables_map &vm,
+                                                      const std::string &Filename)
+{
+    if(vm.count("cache-dir") == 0 || vm.count("no-analysis") != 0)
+    {
+        return nullptr;
+    }
+
+    // Runs with diagnostic side outputs or an external Datalog program are not cached.
+    if(vm.count("debug-dir") || vm.count("interpreter") || vm.count("self-diagnose")
+       || !vm["profile"].as<std::string>().empty())
+    {
+        std::cerr << "Warning: `--cache-dir' is ignored with `--debug-dir', `--interpreter', "
+                     "`--self-diagnose' and `--profile'\n";
+        return nullptr;
+    }
+
+    auto Cache = std::make_unique<ResultCache>(vm["cache-dir"].as<std::string>(),
+                                               DDISASM_FULL_VERSION_STRING);
+    if(!Cache->addInput(Filename))
+    {
+        return nullptr;
+    }
+    for(const char *Option : {"ignore-errors", "no-cfi-directives", "skip-function-analysis",
+                              "with-souffle-relations"})
+    {
+        Cache->addOption(Option, vm.count(Option) ? "1" : "0");
+    }
+    Cache->addOption("souffle-relations-format",
+                     vm["souffle-relations-format"].as<std::string>());
+    for(const char *Option : {"select-relations", "exclude-relations"})
+    {
+        std::string Patterns;
+        if(vm.count(Option))
+        {
+            for(const std::string &Pattern : vm[Option].as<std::vector<std::string>>())
+            {
+                Patterns += Pattern + "\n";
+            }
+        }
+        Cache->addOption(Option, Patterns);
+    }
+    if(vm.count("hints") && !Cache->addFile(vm["hints"].as<std::string>()))
+    {
+        return nullptr;
+    }
+    return Cache;
+}
+
 int main(int argc, char **argv)
 {
     registerAuxDataTypes();
@@ -139,6 +275,10 @@ int main(int argc, char **argv)
         "Specifies the ASM output file; use to '-' print to stdout")(
         "debug", "generate assembler file with debugging information")(
         "debug-dir", po::value<std::string>(), "location to write CSV files for debugging")(
+        "debug-dir-format", po::value<std::string>()->default_value("csv"),
+        "Format of the relation files in --debug-dir: csv, binary, or compressed (binary, "
+        "compressed with zlib). Use `python3 -m ddisasm.relations' to convert binary files "
+        "to CSV.")(
         "hints", po::value<std::string>(), "location of user-provided hints file")(
         "input-file", po::value<std::string>(), "file to disasemble")(
         "ignore-errors", "Return success even if there are disassembly errors.")(
@@ -150,10 +290,36 @@ int main(int argc, char **argv)
         "skip-function-analysis,F",
         "Skip additional analyses to compute more precise function boundaries.")(
         "with-souffle-relations", "Package facts/output relations into an AuxData table.")(
+        "souffle-relations-format", po::value<std::string>()->default_value("csv"),
+        "Format of --with-souffle-relations: csv (the souffleFacts and souffleOutputs AuxData "
+        "tables), or binary or compressed (the souffleFactsBinary and souffleOutputsBinary "
+        "tables; see the ddisasm.relations Python module).")(
+        "select-relations", po::value<std::vector<std::string>>()->multitoken(),
+        "Only write the relations matching these glob patterns to --debug-dir and "
+        "--with-souffle-relations. Patterns match relation names qualified with the pass, e.g. "
+        "disassembly.symbolic_operand or '*.value_reg'.")(
+        "exclude-relations", po::value<std::vector<std::string>>()->multitoken(),
+        "Do not write the relations matching these glob patterns to --debug-dir and "
+        "--with-souffle-relations.")(
         "no-cfi-directives",
         "Do not produce cfi directives. Instead it produces symbolic expressions in .eh_frame "
         "(this functionality is experimental and does not produce reliable results).")(
         "threads,j", po::value<unsigned int>()->default_value(1), "Number of cores to use.")(
+        "module-workers", po::value<unsigned int>()->default_value(0),
+        "Number of modules of a static archive to analyze concurrently; the cores given by "
+        "--threads are split between them. Use 0 to choose automatically.")(
+        "archive-window", po::value<unsigned int>()->default_value(0),
+        "Build, analyze, and print the members of a static archive this many at a time to "
+        "bound peak memory. Use 0 to load the whole archive at once.")(
+        "report", po::value<std::string>(),
+        "Write a JSON report with the time, CPU time, memory growth, and tuple counts of every "
+        "analysis pass of every module to the given file.")(
+        "report-relations",
+        "Include the tuple count of every input and output relation of the Datalog passes in "
+        "the --report file.")(
+        "cache-dir", po::value<std::string>(),
+        "Reuse the GTIRB of earlier runs with the same input, hints, options, and ddisasm "
+        "version from the given directory, and store new results there.")(
         "generate-import-libs", "Generated .DEF and .LIB files for imported libraries (PE).")(
         "generate-resources", "Generated .RES files for embedded resources (PE).")(
         "no-analysis,n",
@@ -208,6 +374,32 @@ int main(int argc, char **argv)
         return 1;
     }
 
+    std::optional<DatalogIO::RelationFormat> DebugDirFormat =
+        DatalogIO::parseRelationFormat(vm["debug-dir-format"].as<std::string>());
+    if(!DebugDirFormat)
+    {
+        std::cerr << "Error: unknown `--debug-dir-format' "
+                  << vm["debug-dir-format"].as<std::string>() << "\n";
+        return 1;
+    }
+    std::optional<DatalogIO::RelationFormat> SouffleRelationsFormat =
+        DatalogIO::parseRelationFormat(vm["souffle-relations-format"].as<std::string>());
+    if(!SouffleRelationsFormat)
+    {
+        std::cerr << "Error: unknown `--souffle-relations-format' "
+                  << vm["souffle-relations-format"].as<std::string>() << "\n";
+        return 1;
+    }
+    for(const char *Option : {"debug-dir-format", "souffle-relations-format"})
+    {
+        if(vm[Option].as<std::string>() == "compressed" && !DatalogIO::supportsCompression())
+        {
+            std::cerr << "Error: `--" << Option
+                      << " compressed' requires ddisasm to be built with zlib\n";
+            return 1;
+        }
+    }
+
     const std::string &ProfileDir = vm["profile"].as<std::string>();
 #if !defined(DDISASM_SOUFFLE_PROFILING)
     if(!ProfileDir.empty() && !vm.count("interpreter"))
@@ -219,12 +411,177 @@ int main(int argc, char **argv)
 
     checkOutputParamIsWritable(vm, "ir");
     checkOutputParamIsWritable(vm, "json");
+    checkOutputParamIsWritable(vm, "report");
+
+    if(vm.count("report-relations") && !vm.count("report"))
+    {
+        std::cerr << "Error: missing `--report' argument required by `--report-relations'\n";
+        return 1;
+    }
+
+    std::shared_ptr<PipelineReport> Report;
+    if(vm.count("report"))
+    {
+        Report = std::make_shared<PipelineReport>(DDISASM_FULL_VERSION_STRING,
+                                                  vm.count("report-relations") != 0);
+    }
+
+    DatalogIO::RelationFilter RelationFilter;
+    if(vm.count("select-relations"))
+    {
+        for(const std::string &Pattern : vm["select-relations"].as<std::vector<std::string>>())
+        {
+            RelationFilter.select(Pattern);
+        }
+    }
+    if(vm.count("exclude-relations"))
+    {
+        for(const std::string &Pattern : vm["exclude-relations"].as<std::vector<std::string>>())
+        {
+            RelationFilter.exclude(Pattern);
+        }
+    }
+
+    unsigned int Workers = vm["module-workers"].as<unsigned int>();
+    if(!ProfileDir.empty())
+    {
+        // Souffle profiling information is collected in a global database.
+        Workers = 1;
+    }
+    unsigned int ModuleCount = 0;
+    ThreadBudget Budget{};
+
+    // TODO: currently, hints files have no support for static archives containing multiple modules;
+    // all hints are used when processing each module, which is most likely not desirable.
+    auto Configure = [&](AnalysisPipeline &Pipeline) {
+        Pipeline.push<DisassemblyPass>(
+            vm.count("self-diagnose") != 0, vm.count("ignore-errors") != 0,
+            vm.count("no-cfi-directives") != 0, vm.count("skip-function-analysis") == 0);
+
+        if(vm.count("skip-function-analysis") == 0)
+        {
+            Pipeline.push<SccPass>();
+            Pipeline.push<NoReturnPass>();
+            Pipeline.push<FunctionInferencePass>();
+        }
+
+        Pipeline.setDatalogThreadCount(Budget.DatalogThreads);
+        if(!ProfileDir.empty())
+        {
+            Pipeline.setDatalogProfileDir(ProfileDir);
+        }
+
+        if(vm.count("debug-dir"))
+        {
+            Pipeline.configureDebugDir(vm["debug-dir"].as<std::string>(), ModuleCount > 1);
+            Pipeline.setDebugDirFormat(*DebugDirFormat);
+        }
+
+        if(vm.count("interpreter"))
+        {
+            Pipeline.configureSouffleInterpreter(
+                vm["interpreter"].as<std::string>(),
+                vm.count("library-dir") ? vm["library-dir"].as<std::string>() : std::string());
+        }
+
+        if(vm.count("hints"))
+        {
+            Pipeline.loadHints(vm["hints"].as<std::string>());
+        }
+
+        if(vm.count("with-souffle-relations"))
+        {
+            Pipeline.enableSouffleOutputs(*SouffleRelationsFormat);
+        }
+
+        Pipeline.setRelationFilter(RelationFilter);
+
+        if(Report)
+        {
+            Pipeline.addListener(std::make_shared<ReportPipelineListener>(Report));
+        }
+    };
+
+    std::string Filename = vm["input-file"].as<std::string>();
+    unsigned int ArchiveWindow = vm["archive-window"].as<unsigned int>();
+    if(ArchiveWindow > 0 && ArchiveReader::isAr(Filename))
+    {
+        if(vm.count("ir") || vm.count("json"))
+        {
+            std::cerr << "Error: `--archive-window' cannot be combined with `--ir' or `--json'\n";
+            return 1;
+        }
+
+        // Build, analyze, and print at most ArchiveWindow members at a time,
+        // releasing each window before the next one is built.
+        try
+        {
+            ModuleCount = ArchiveReader::read(Filename).Files.size();
+        }
+        catch(ArchiveReaderException &e)
+        {
+            std::cerr << "ERROR: " << Filename << ": " << e.what() << "\n";
+            return 1;
+        }
+        if(vm.count("asm") != 0 && ModuleCount == 1)
+        {
+            checkOutputParamIsWritable(vm, "asm");
+        }
+        Budget = splitThreadBudget(vm["threads"].as<unsigned int>(), Workers,
+                                   std::min(ModuleCount, ArchiveWindow));
+        if(!ProfileDir.empty())
+        {
+            fs::create_directories(ProfileDir);
+        }
+
+        ModuleScheduler Scheduler(Budget.ModuleWorkers, Configure);
+        gtirb_pprint::PrettyPrinter pprinter;
+        std::error_code Error;
+        try
+        {
+            Error = GtirbBuilder::readArchive(
+                Filename, ArchiveWindow, [&](GtirbBuilder::GTIRB &Part) {
+                    Part.IR->addAuxData<gtirb::schema::DdisasmVersion>(
+                        DDISASM_FULL_VERSION_STRING);
+                    Scheduler.run(*Part.Context, *Part.IR);
+                    for(auto &Module : Part.IR->modules())
+                    {
+                        printModule(vm, pprinter, *Part.Context, Module, ModuleCount > 1);
+                    }
+                    std::cerr << "Finished archive window";
+                    printPeakMemoryUsage();
+                    std::cerr << "\n";
+                });
+        }
+        catch(const AnalysisPassError &)
+        {
+            // The errors have been reported by the pipeline listener.
+            return EXIT_FAILURE;
+        }
+        if(Error)
+        {
+            std::cerr << "\nERROR: " << Filename << ": " << Error.message() << "\n";
+            return 1;
+        }
+        writeReport(vm, Report.get());
+        return EXIT_SUCCESS;
+    }
+
+    // Reuse the result of an earlier run on the same input, if there is one.
+    std::unique_ptr<ResultCache> Cache = createResultCache(vm, Filename);
+    auto CachedContext = std::make_shared<gtirb::Context>();
+    gtirb::IR *CachedIR = Cache ? Cache->load(*CachedContext) : nullptr;
 
     // Parse and build a GTIRB module from a supported binary object file.
-    std::cerr << "Building the initial gtirb representation " << std::flush;
+    std::cerr << (CachedIR ? "Loading the cached gtirb representation "
+                           : "Building the initial gtirb representation ")
+              << std::flush;
     auto StartBuildZeroIR = std::chrono::high_resolution_clock::now();
-    std::string Filename = vm["input-file"].as<std::string>();
-    auto GTIRB = GtirbBuilder::read(Filename);
+    gtirb::ErrorOr<GtirbBuilder::GTIRB> GTIRB = GtirbBuilder::GTIRB{CachedContext, CachedIR};
+    if(!CachedIR)
+    {
+        GTIRB = GtirbBuilder::read(Filename);
+    }
     if(!GTIRB)
     {
         std::cerr << "\nERROR: " << Filename << ": " << GTIRB.getError().message() << "\n";
@@ -232,7 +589,7 @@ int main(int argc, char **argv)
     }
 
     auto Modules = GTIRB->IR->modules();
-    unsigned int ModuleCount = std::distance(std::begin(Modules), std::end(Modules));
+    ModuleCount = std::distance(std::begin(Modules), std::end(Modules));
     if(vm.count("asm") != 0)
     {
         // We don't know whether we will be creating a directory and writing
@@ -248,6 +605,7 @@ int main(int argc, char **argv)
     // Add `ddisasmVersion' aux data table.
     GTIRB->IR->addAuxData<gtirb::schema::DdisasmVersion>(DDISASM_FULL_VERSION_STRING);
     printElapsedTimeSince(StartBuildZeroIR);
+    printPeakMemoryUsage();
     std::cerr << "\n";
 
     if(!GTIRB->IR)
@@ -273,58 +631,31 @@ int main(int argc, char **argv)
         return 0;
     }
 
-    AnalysisPipeline Pipeline;
-    Pipeline.addListener(std::make_shared<DDisasmPipelineListener>());
-    Pipeline.push<DisassemblyPass>(vm.count("self-diagnose") != 0, vm.count("ignore-errors") != 0,
-                                   vm.count("no-cfi-directives") != 0);
-
-    if(vm.count("skip-function-analysis") == 0)
-    {
-        Pipeline.push<SccPass>();
-        Pipeline.push<NoReturnPass>();
-        Pipeline.push<FunctionInferencePass>();
-    }
-
-    Pipeline.setDatalogThreadCount(vm["threads"].as<unsigned int>());
+    Budget = splitThreadBudget(vm["threads"].as<unsigned int>(), Workers, ModuleCount);
     if(!ProfileDir.empty())
     {
         fs::create_directories(ProfileDir);
-        Pipeline.setDatalogProfileDir(ProfileDir);
-    }
-
-    if(vm.count("debug-dir"))
-    {
-        Pipeline.configureDebugDir(vm["debug-dir"].as<std::string>(), ModuleCount > 1);
     }
 
-    if(vm.count("interpreter"))
-    {
-        Pipeline.configureSouffleInterpreter(
-            vm["interpreter"].as<std::string>(),
-            vm.count("library-dir") ? vm["library-dir"].as<std::string>() : std::string());
-    }
-
-    // TODO: currently, hints files have no support for static archives containing multiple modules;
-    // all hints are used when processing each module, which is most likely not desirable.
-    if(vm.count("hints"))
-    {
-        Pipeline.loadHints(vm["hints"].as<std::string>());
-    }
-
-    if(vm.count("with-souffle-relations"))
-    {
-        Pipeline.enableSouffleOutputs();
-    }
-
-    for(auto &Module : Modules)
+    if(!CachedIR)
     {
-        std::cerr << "Processing module: " << Module.getName() << "\n";
-        Pipeline.run(*GTIRB->Context, Module);
+        ModuleScheduler Scheduler(Budget.ModuleWorkers, Configure);
+        try
+        {
+            Scheduler.run(*GTIRB->Context, *GTIRB->IR);
+        }
+        catch(const AnalysisPassError &)
+        {
+            // The errors have been reported by the pipeline listener.
+            return EXIT_FAILURE;
+        }
 
-        // Remove provisional AuxData tables.
-        Module.removeAuxData<gtirb::schema::Relocations>();
-        Module.removeAuxData<gtirb::schema::SectionIndex>();
+        if(Cache && !Cache->store(*GTIRB->IR))
+        {
+            std::cerr << "Warning: failed to store the result in " << Cache->path() << "\n";
+        }
     }
+    writeReport(vm, Report.get());
 
     // Output GTIRB
     if(vm.count("ir") != 0)
@@ -379,71 +710,9 @@ int main(int argc, char **argv)
     // Pretty-print
     if(vm.count("asm") != 0 || (vm.count("ir") == 0 && vm.count("json") == 0))
     {
-        std::string ListingMode = vm.count("debug") != 0 ? "debug" : "";
         for(auto &Module : Modules)
         {
-            const std::string &format = gtirb_pprint::getModuleFileFormat(Module);
-            const std::string &isa = gtirb_pprint::getModuleISA(Module);
-            const std::string &syntax =
-                gtirb_pprint::getDefaultSyntax(format, isa, ListingMode).value_or("");
-            auto target = std::make_tuple(format, isa, syntax);
-            pprinter.setTarget(std::move(target));
-
-            // Apply pre-print transforms provided by the pretty-printer library.
-            // This MODIFIES the GTIRB, so it's important to do this *after*
-            // writing the GTIRB output to disk if we're doing both.
-            gtirb_pprint::applyFixups(*GTIRB->Context, Module, pprinter);
-
-            if(vm.count("debug") != 0)
-            {
-                pprinter.setListingMode("debug");
-            }
-
-            if(vm.count("keep-functions") != 0)
-            {
-                for(auto keep : vm["keep-functions"].as<std::vector<std::string>>())
-                {
-                    pprinter.symbolPolicy().keep(keep);
-                }
-            }
-
-            fs::path AsmPath;
-            std::ofstream AsmFileStream;
-            bool UseStdout = true;
-            if(vm.count("asm") != 0)
-            {
-                std::string name = vm["asm"].as<std::string>();
-                if(name != "-")
-                {
-                    AsmPath = name;
-                }
-            }
-
-            if(!AsmPath.empty())
-            {
-                // If there are multiple modules, use the asm argument as a directory.
-                // Each module will get its own .s file.
-                if(ModuleCount > 1)
-                {
-                    fs::create_directories(AsmPath);
-                    std::string name = Module.getName();
-
-                    // Strip ".o" extension if it exists.
-                    if(name.compare(name.size() - 2, 2, ".o") == 0)
-                    {
-                        name.erase(name.size() - 2);
-                    }
-                    AsmPath /= name + ".s";
-                }
-                AsmFileStream.open(AsmPath.string());
-                UseStdout = false;
-            }
-
-            std::cerr << "Printing assembler " << std::flush;
-            auto StartPrinting = std::chrono::high_resolution_clock::now();
-            pprinter.print(UseStdout ? std::cout : AsmFileStream, *GTIRB->Context, Module);
-            printElapsedTimeSince(StartPrinting);
-            std::cerr << "\n";
+            printModule(vm, pprinter, *GTIRB->Context, Module, ModuleCount > 1);
         }
     }
 
@@ -0,0 +1,98 @@
+//===- ModuleScheduler.cpp --------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2023 GrammaTech, Inc.
+//
+//  This code is licensed under the GNU Affero General Public License
+//  as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version. See the
+//  LICENSE.txt file in the project root for license terms or visit
+//  https://www.gnu.org/licenses/agpl.txt.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU Affero General Public License for more details.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+#include "ModuleScheduler.h"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "AuxDataSchema.h"
+#include "CliDriver.h"
+#include "Parallel.h"
+
+ThreadBudget splitThreadBudget(unsigned int Threads, unsigned int Workers,
+                               unsigned int ModuleCount)
+{
+    Threads = std::max(Threads, 1u);
+    ModuleCount = std::max(ModuleCount, 1u);
+    if(Workers == 0)
+    {
+        Workers = std::min(Threads, ModuleCount);
+    }
+    Workers = std::min(Workers, ModuleCount);
+    return {Workers, std::max(Threads / Workers, 1u)};
+}
+
+void ModuleScheduler::run(gtirb::Context& Context, gtirb::IR& IR)
+{
+    std::vector<gtirb::Module*> Modules;
+    for(gtirb::Module& Module : IR.modules())
+    {
+        Modules.push_back(&Module);
+    }
+
+    unsigned int WorkerCount = std::max(std::min<unsigned int>(Workers, Modules.size()), 1u);
+    bool Concurrent = WorkerCount > 1;
+
+    std::mutex IRMutex;
+    std::vector<std::unique_ptr<AnalysisPipeline>> Pipelines;
+    std::vector<std::shared_ptr<DDisasmPipelineListener>> Listeners;
+    for(unsigned int I = 0; I < WorkerCount; I++)
+    {
+        auto Listener = std::make_shared<DDisasmPipelineListener>(Concurrent);
+        auto Pipeline = std::make_unique<AnalysisPipeline>();
+        Pipeline->addListener(Listener);
+        Configure(*Pipeline);
+        if(Concurrent)
+        {
+            Pipeline->setIRMutex(&IRMutex);
+        }
+        Pipelines.push_back(std::move(Pipeline));
+        Listeners.push_back(Listener);
+    }
+
+    parallelForWorkers(Modules.size(), WorkerCount, [&](size_t Worker, size_t Index) {
+        gtirb::Module& Module = *Modules[Index];
+        DDisasmPipelineListener& Listener = *Listeners[Worker];
+
+        Listener.stream() << "Processing module: " << Module.getName() << "\n";
+        try
+        {
+            Pipelines[Worker]->run(Context, Module);
+        }
+        catch(...)
+        {
+            Listener.flush();
+            throw;
+        }
+
+        {
+            // Remove provisional AuxData tables.
+            std::lock_guard<std::mutex> Lock(IRMutex);
+            Module.removeAuxData<gtirb::schema::Relocations>();
+            Module.removeAuxData<gtirb::schema::SectionIndex>();
+        }
+        Listener.flush();
+    });
+}
@@ -0,0 +1,75 @@
+//===- ModuleScheduler.h ----------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2023 GrammaTech, Inc.
+//
+//  This code is licensed under the GNU Affero General Public License
+//  as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version. See the
+//  LICENSE.txt file in the project root for license terms or visit
+//  https://www.gnu.org/licenses/agpl.txt.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU Affero General Public License for more details.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+#ifndef _MODULE_SCHEDULER_H_
+#define _MODULE_SCHEDULER_H_
+
+#include <functional>
+#include <gtirb/gtirb.hpp>
+
+#include "AnalysisPipeline.h"
+
+/**
+Division of the `--threads' budget between module workers and Souffle threads.
+*/
+struct ThreadBudget
+{
+    unsigned int ModuleWorkers;
+    unsigned int DatalogThreads;
+};
+
+/**
+Split Threads cores between Workers module workers for an IR with ModuleCount
+modules. A Workers value of zero selects as many workers as the budget and the
+number of modules allow.
+*/
+ThreadBudget splitThreadBudget(unsigned int Threads, unsigned int Workers,
+                               unsigned int ModuleCount);
+
+/**
+The ModuleScheduler runs an analysis pipeline on every module of an IR,
+processing several modules concurrently.
+
+Each worker owns an AnalysisPipeline that is configured once and reused for
+all the modules it processes, relying on AnalysisPass::clear(). Workers share
+the GTIRB through a single lock, so only the thread-safe analyze phases of the
+pipelines overlap. Progress is reported per module, and the results do not
+depend on the number of workers.
+*/
+class ModuleScheduler
+{
+public:
+    using Configuration = std::function<void(AnalysisPipeline&)>;
+
+    ModuleScheduler(unsigned int Workers, Configuration Configure)
+        : Workers(Workers), Configure(Configure)
+    {
+    }
+
+    void run(gtirb::Context& Context, gtirb::IR& IR);
+
+private:
+    unsigned int Workers;
+    Configuration Configure;
+};
+
+#endif /* _MODULE_SCHEDULER_H_ */
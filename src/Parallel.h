@@ -0,0 +1,105 @@
+//===- Parallel.h -----------------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2023 GrammaTech, Inc.
+//
+//  This code is licensed under the GNU Affero General Public License
+//  as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version. See the
+//  LICENSE.txt file in the project root for license terms or visit
+//  https://www.gnu.org/licenses/agpl.txt.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU Affero General Public License for more details.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+#ifndef _PARALLEL_H_
+#define _PARALLEL_H_
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+Call F(Worker, Index) for every Index in [0, Count) on at most Threads worker threads.
+
+Indices are handed out in increasing order from a shared counter. Worker identifies the
+calling worker in [0, Threads), so callers can keep per-worker state without locking. With a
+single worker everything runs on the calling thread. The first exception thrown by F stops
+the remaining work and is rethrown once all workers have finished.
+*/
+template <typename Function>
+void parallelForWorkers(size_t Count, unsigned int Threads, Function&& F)
+{
+    size_t Workers = std::min<size_t>(std::max(Threads, 1u), Count);
+    if(Workers <= 1)
+    {
+        for(size_t Index = 0; Index < Count; Index++)
+        {
+            F(size_t(0), Index);
+        }
+        return;
+    }
+
+    std::atomic<size_t> Next(0);
+    std::atomic<bool> Failed(false);
+    std::exception_ptr Error;
+    std::mutex ErrorMutex;
+
+    auto Work = [&](size_t Worker) {
+        try
+        {
+            for(size_t Index = Next++; Index < Count && !Failed; Index = Next++)
+            {
+                F(Worker, Index);
+            }
+        }
+        catch(...)
+        {
+            std::lock_guard<std::mutex> Lock(ErrorMutex);
+            if(!Error)
+            {
+                Error = std::current_exception();
+            }
+            Failed = true;
+        }
+    };
+
+    std::vector<std::thread> Pool;
+    Pool.reserve(Workers - 1);
+    for(size_t Worker = 1; Worker < Workers; Worker++)
+    {
+        Pool.emplace_back(Work, Worker);
+    }
+    Work(0);
+    for(std::thread& Thread : Pool)
+    {
+        Thread.join();
+    }
+
+    if(Error)
+    {
+        std::rethrow_exception(Error);
+    }
+}
+
+/**
+Call F(Index) for every Index in [0, Count) on at most Threads worker threads.
+*/
+template <typename Function>
+void parallelFor(size_t Count, unsigned int Threads, Function&& F)
+{
+    parallelForWorkers(Count, Threads, [&F](size_t, size_t Index) { F(Index); });
+}
+
+#endif // _PARALLEL_H_
@@ -75,6 +75,8 @@ void registerAuxDataTypes()
     gtirb::AuxDataContainer::registerAuxDataType<PeDebugData>();
     gtirb::AuxDataContainer::registerAuxDataType<SouffleFacts>();
     gtirb::AuxDataContainer::registerAuxDataType<SouffleOutputs>();
+    gtirb::AuxDataContainer::registerAuxDataType<SouffleFactsBinary>();
+    gtirb::AuxDataContainer::registerAuxDataType<SouffleOutputsBinary>();
     gtirb::AuxDataContainer::registerAuxDataType<RawEntries>();
     gtirb::AuxDataContainer::registerAuxDataType<Overlay>();
     gtirb::AuxDataContainer::registerAuxDataType<ElfDynamicInit>();
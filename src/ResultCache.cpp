@@ -0,0 +1,135 @@
+//===- ResultCache.cpp ------------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2023 GrammaTech, Inc.
+//
+//  This code is licensed under the GNU Affero General Public License
+//  as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version. See the
+//  LICENSE.txt file in the project root for license terms or visit
+//  https://www.gnu.org/licenses/agpl.txt.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU Affero General Public License for more details.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+#include "ResultCache.h"
+
+#include <fstream>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/uuid/name_generator_sha1.hpp>
+#include <boost/uuid/nil_generator.hpp>
+#include <boost/uuid/uuid_io.hpp>
+
+namespace fs = boost::filesystem;
+
+ResultCache::ResultCache(const std::string& Dir, const std::string& Version)
+    : Dir(Dir), Digest(boost::uuids::nil_uuid())
+{
+    addOption("ddisasm-result-cache", "1");
+    addOption("version", Version);
+}
+
+void ResultCache::update(const void* Data, size_t Size)
+{
+    // Chain SHA-1 name-based UUIDs: every update hashes its data in the
+    // namespace of the previous digest.
+    Digest = boost::uuids::name_generator_sha1(Digest)(Data, Size);
+}
+
+bool ResultCache::addFile(const std::string& Path)
+{
+    std::ifstream Stream(Path, std::ios::in | std::ios::binary);
+    if(!Stream)
+    {
+        return false;
+    }
+
+    addOption("file");
+    std::vector<char> Buffer(1 << 20);
+    while(Stream)
+    {
+        Stream.read(Buffer.data(), Buffer.size());
+        update(Buffer.data(), Stream.gcount());
+    }
+    return !Stream.bad();
+}
+
+bool ResultCache::addInput(const std::string& Path)
+{
+    addOption("input", Path);
+    return addFile(Path);
+}
+
+void ResultCache::addOption(const std::string& Name, const std::string& Value)
+{
+    update(Name.data(), Name.size());
+    update(Value.data(), Value.size());
+}
+
+std::string ResultCache::key() const
+{
+    return boost::uuids::to_string(Digest);
+}
+
+std::string ResultCache::path() const
+{
+    return (fs::path(Dir) / (key() + ".gtirb")).string();
+}
+
+gtirb::IR* ResultCache::load(gtirb::Context& Context) const
+{
+    std::ifstream Stream(path(), std::ios::in | std::ios::binary);
+    if(!Stream)
+    {
+        return nullptr;
+    }
+    if(gtirb::ErrorOr<gtirb::IR*> Result = gtirb::IR::load(Context, Stream))
+    {
+        return *Result;
+    }
+    return nullptr;
+}
+
+bool ResultCache::store(const gtirb::IR& IR) const
+{
+    boost::system::error_code Error;
+    fs::create_directories(Dir, Error);
+    if(Error)
+    {
+        return false;
+    }
+
+    fs::path Temporary = fs::path(Dir) / fs::unique_path(key() + "-%%%%%%%%.tmp");
+    {
+        std::ofstream Stream(Temporary.string(), std::ios::out | std::ios::binary);
+        if(!Stream)
+        {
+            return false;
+        }
+        IR.save(Stream);
+        if(!Stream)
+        {
+            Stream.close();
+            fs::remove(Temporary, Error);
+            return false;
+        }
+    }
+
+    fs::rename(Temporary, path(), Error);
+    if(Error)
+    {
+        fs::remove(Temporary, Error);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,99 @@
+//===- ResultCache.h --------------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2023 GrammaTech, Inc.
+//
+//  This code is licensed under the GNU Affero General Public License
+//  as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version. See the
+//  LICENSE.txt file in the project root for license terms or visit
+//  https://www.gnu.org/licenses/agpl.txt.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU Affero General Public License for more details.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+#ifndef _RESULT_CACHE_H_
+#define _RESULT_CACHE_H_
+
+#include <string>
+
+#include <boost/uuid/uuid.hpp>
+#include <gtirb/gtirb.hpp>
+
+/**
+A ResultCache keeps the GTIRB produced by a complete ddisasm run on local disk.
+
+Entries are addressed by a digest of everything that determines the result:
+the ddisasm version (which identifies the embedded Datalog program), the path
+and bytes of the input, the bytes of the hints file, and the analysis options. A changed input or a
+new ddisasm build therefore never reuses a stale entry.
+*/
+class ResultCache
+{
+public:
+    /**
+    Create a cache in directory Dir for results of the given ddisasm version,
+    normally DDISASM_FULL_VERSION_STRING.
+    */
+    ResultCache(const std::string& Dir, const std::string& Version);
+
+    /**
+    Add the contents of the file at Path to the key.
+
+    Returns false if the file cannot be read.
+    */
+    bool addFile(const std::string& Path);
+
+    /**
+    Add the binary at Path to the key: its contents, and the path itself, which
+    GtirbBuilder records as the module name and binary path.
+
+    Returns false if the file cannot be read.
+    */
+    bool addInput(const std::string& Path);
+
+    /**
+    Add an option and its value to the key.
+    */
+    void addOption(const std::string& Name, const std::string& Value = "");
+
+    /**
+    Hexadecimal digest of the key.
+    */
+    std::string key() const;
+
+    /**
+    Location of the entry for the current key.
+    */
+    std::string path() const;
+
+    /**
+    Load the cached IR for the current key into Context, or return nullptr if
+    there is no usable entry.
+    */
+    gtirb::IR* load(gtirb::Context& Context) const;
+
+    /**
+    Store IR as the entry for the current key.
+
+    The entry is written to a temporary file and renamed into place, so
+    concurrent ddisasm processes never observe a partial entry.
+    */
+    bool store(const gtirb::IR& IR) const;
+
+private:
+    void update(const void* Data, size_t Size);
+
+    std::string Dir;
+    boost::uuids::uuid Digest;
+};
+
+#endif /* _RESULT_CACHE_H_ */
@@ -0,0 +1,72 @@
+#ifndef _BENCHMARK_H_
+#define _BENCHMARK_H_
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/**
+A microbenchmark registered with DDISASM_BENCHMARK and run by BenchDdisasm.
+*/
+struct Benchmark
+{
+    std::string Name;
+    std::function<void()> Run;
+};
+
+std::vector<Benchmark>& benchmarks();
+
+struct BenchmarkRegistration
+{
+    BenchmarkRegistration(const std::string& Name, std::function<void()> Run)
+    {
+        benchmarks().push_back({Name, Run});
+    }
+};
+
+#define DDISASM_BENCHMARK(Name)                                   \
+    static void Name();                                           \
+    static BenchmarkRegistration Name##Registration(#Name, Name); \
+    static void Name()
+
+// Results are accumulated here so that the measured work is not optimized away.
+extern volatile uint64_t BenchmarkSink;
+
+// Peak resident set size of the process in KiB, or 0 where it is not available.
+uint64_t peakMemory();
+
+/**
+Run Fn, which performs Operations operations and returns a checksum, until at
+least half a second has elapsed, and report the time per operation under Label.
+*/
+template <typename Function>
+double measure(const std::string& Label, size_t Operations, Function&& Fn)
+{
+    using Clock = std::chrono::steady_clock;
+    const std::chrono::duration<double> MinTime(0.5);
+
+    // Warm up caches.
+    BenchmarkSink = BenchmarkSink + Fn();
+
+    size_t Runs = 0;
+    auto Start = Clock::now();
+    std::chrono::duration<double> Elapsed(0);
+    do
+    {
+        BenchmarkSink = BenchmarkSink + Fn();
+        Runs++;
+        Elapsed = Clock::now() - Start;
+    } while(Elapsed < MinTime);
+
+    double Nanoseconds = Elapsed.count() * 1e9 / (double(Runs) * double(Operations));
+    std::cout << "    " << std::left << std::setw(48) << Label << std::right << std::setw(12)
+              << std::fixed << std::setprecision(2) << Nanoseconds << " ns/op" << std::setw(12)
+              << std::setprecision(1) << (1e3 / Nanoseconds) << " Mop/s\n";
+    return Nanoseconds;
+}
+
+#endif // _BENCHMARK_H_
@@ -0,0 +1,57 @@
+#include "BenchmarkInputs.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+std::optional<GtirbBuilder::GTIRB> buildX64()
+{
+    if(const char* Path = std::getenv("DDISASM_BENCH_X64"))
+    {
+        auto GTIRB = GtirbBuilder::read(Path);
+        if(!GTIRB)
+        {
+            std::cerr << "    Could not read " << Path << ": " << GTIRB.getError().message()
+                      << "\n";
+            return std::nullopt;
+        }
+        return *GTIRB;
+    }
+
+    auto Context = std::make_shared<gtirb::Context>();
+    gtirb::IR* IR = gtirb::IR::Create(*Context);
+    gtirb::Module* Module = IR->addModule(*Context, "bench");
+    Module->setISA(gtirb::ISA::X64);
+    Module->setByteOrder(gtirb::ByteOrder::Little);
+
+    const uint64_t TextAddr = 0x10000;
+    const uint64_t TextSize = 16 << 20;
+    std::mt19937_64 Random(4);
+
+    std::vector<uint8_t> Bytes(TextSize);
+    for(uint8_t& Byte : Bytes)
+    {
+        Byte = static_cast<uint8_t>(Random());
+    }
+    gtirb::Section* Text = Module->addSection(*Context, ".text");
+    Text->addFlag(gtirb::SectionFlag::Loaded);
+    Text->addFlag(gtirb::SectionFlag::Executable);
+    Text->addFlag(gtirb::SectionFlag::Initialized);
+    Text->addByteInterval(*Context, gtirb::Addr(TextAddr), Bytes.begin(), Bytes.end(),
+                          Bytes.size(), Bytes.size());
+
+    std::vector<uint64_t> Words(1 << 19);
+    for(uint64_t& Word : Words)
+    {
+        Word = Random() % 2 ? TextAddr + Random() % TextSize : Random();
+    }
+    auto* Data = reinterpret_cast<const uint8_t*>(Words.data());
+    size_t DataSize = Words.size() * sizeof(uint64_t);
+    gtirb::Section* DataSection = Module->addSection(*Context, ".data");
+    DataSection->addFlag(gtirb::SectionFlag::Loaded);
+    DataSection->addFlag(gtirb::SectionFlag::Initialized);
+    DataSection->addByteInterval(*Context, gtirb::Addr(TextAddr + TextSize), Data,
+                                 Data + DataSize, DataSize, DataSize);
+
+    return GtirbBuilder::GTIRB{Context, IR};
+}
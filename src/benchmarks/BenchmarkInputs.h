@@ -0,0 +1,15 @@
+#ifndef _BENCHMARK_INPUTS_H_
+#define _BENCHMARK_INPUTS_H_
+
+#include <optional>
+
+#include "../gtirb-builder/GtirbBuilder.h"
+
+/**
+Load the x64 binary named by the DDISASM_BENCH_X64 environment variable or, if it is not
+set, build a module with 16 MiB of pseudo-random code and 4 MiB of data that is half
+pointers into the code.
+*/
+std::optional<GtirbBuilder::GTIRB> buildX64();
+
+#endif // _BENCHMARK_INPUTS_H_
@@ -0,0 +1,129 @@
+#include <gtirb/gtirb.hpp>
+#include <random>
+
+#include "../Functors.h"
+#include "Benchmark.h"
+
+// Byte interval lookup as done before the data functors indexed the module.
+static const gtirb::ByteInterval* referenceByteInterval(const gtirb::Module& Module, uint64_t EA,
+                                                        size_t Size)
+{
+    for(const auto& Section : Module.findSectionsOn(gtirb::Addr(EA)))
+    {
+        bool Executable = Section.isFlagSet(gtirb::SectionFlag::Executable);
+        bool Initialized = Section.isFlagSet(gtirb::SectionFlag::Initialized);
+        bool Loaded = Section.isFlagSet(gtirb::SectionFlag::Loaded);
+        if(Loaded && (Executable || Initialized))
+        {
+            for(const auto& ByteInterval : Section.findByteIntervalsOn(gtirb::Addr(EA)))
+            {
+                uint64_t Addr = static_cast<uint64_t>(*ByteInterval.getAddress());
+                uint64_t IntervalSize = ByteInterval.getInitializedSize();
+                if(EA + Size > Addr + IntervalSize)
+                {
+                    continue;
+                }
+                return &ByteInterval;
+            }
+        }
+    }
+    return nullptr;
+}
+
+static uint32_t referenceDataU32(const gtirb::Module& Module, uint64_t EA)
+{
+    uint32_t Value = 0;
+    if(const gtirb::ByteInterval* ByteInterval = referenceByteInterval(Module, EA, sizeof(Value)))
+    {
+        uint64_t Addr = static_cast<uint64_t>(*ByteInterval->getAddress());
+        memcpy(&Value, ByteInterval->rawBytes<const uint8_t>() + EA - Addr, sizeof(Value));
+    }
+    return Value;
+}
+
+constexpr uint64_t SectionCount = 2000;
+constexpr uint64_t SectionSize = 0x1000;
+constexpr uint64_t SectionStride = 0x1800;
+
+// A module with many small data sections separated by gaps.
+static gtirb::Module* buildModule(gtirb::Context& Context)
+{
+    gtirb::IR* IR = gtirb::IR::Create(Context);
+    gtirb::Module* Module = IR->addModule(Context, "bench");
+    Module->setByteOrder(gtirb::ByteOrder::Little);
+
+    std::mt19937_64 Random(1);
+    std::vector<uint8_t> Bytes(SectionSize);
+    for(uint64_t I = 0; I < SectionCount; I++)
+    {
+        gtirb::Section* Section = Module->addSection(Context, ".data" + std::to_string(I));
+        Section->addFlag(gtirb::SectionFlag::Loaded);
+        Section->addFlag(gtirb::SectionFlag::Initialized);
+        for(uint8_t& Byte : Bytes)
+        {
+            Byte = static_cast<uint8_t>(Random());
+        }
+        Section->addByteInterval(Context, gtirb::Addr(0x10000 + I * SectionStride), Bytes.begin(),
+                                 Bytes.end(), SectionSize, SectionSize);
+    }
+    return Module;
+}
+
+// Addresses read by the functors: short sequential runs at random places,
+// with some of them outside of any section.
+static std::vector<uint64_t> buildAddresses()
+{
+    std::mt19937_64 Random(2);
+    std::vector<uint64_t> Addresses;
+    while(Addresses.size() < (1 << 20))
+    {
+        uint64_t Start = 0x10000 + Random() % (SectionCount * SectionStride);
+        for(uint64_t I = 0; I < 16; I++)
+        {
+            Addresses.push_back(Start + I * 4);
+        }
+    }
+    return Addresses;
+}
+
+DDISASM_BENCHMARK(functor_data_lookup)
+{
+    gtirb::Context Context;
+    gtirb::Module* Module = buildModule(Context);
+    std::vector<uint64_t> Addresses = buildAddresses();
+    FunctorContext.useModule(Module);
+
+    measure("getByteInterval (section scan)", Addresses.size(), [&]() {
+        uint64_t Found = 0;
+        for(uint64_t EA : Addresses)
+        {
+            Found += referenceByteInterval(*Module, EA, 4) != nullptr;
+        }
+        return Found;
+    });
+    measure("getByteInterval (index)", Addresses.size(), [&]() {
+        uint64_t Found = 0;
+        for(uint64_t EA : Addresses)
+        {
+            Found += FunctorContext.getByteInterval(EA, 4) != nullptr;
+        }
+        return Found;
+    });
+
+    measure("functor_data_u32 (section scan)", Addresses.size(), [&]() {
+        uint64_t Sum = 0;
+        for(uint64_t EA : Addresses)
+        {
+            Sum += referenceDataU32(*Module, EA);
+        }
+        return Sum;
+    });
+    measure("functor_data_u32 (index)", Addresses.size(), [&]() {
+        uint64_t Sum = 0;
+        for(uint64_t EA : Addresses)
+        {
+            Sum += functor_data_u32(EA);
+        }
+        return Sum;
+    });
+}
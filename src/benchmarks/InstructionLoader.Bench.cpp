@@ -0,0 +1,163 @@
+#include <algorithm>
+#include <chrono>
+#include <gtirb/gtirb.hpp>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <thread>
+
+#include "../gtirb-decoder/CompositeLoader.h"
+#include "../gtirb-decoder/arch/X64Loader.h"
+#include "Benchmark.h"
+#include "BenchmarkInputs.h"
+
+// Operand deduplication as done before OperandFacts used hash tables.
+class ReferenceOperandFacts
+{
+public:
+    uint64_t add(const relations::Operand& Op)
+    {
+        return std::visit(*this, Op);
+    }
+
+    uint64_t operator()(const relations::ImmOp& Op)
+    {
+        return index(Imm, Op);
+    }
+
+    uint64_t operator()(const relations::RegOp& Op)
+    {
+        return index(Reg, Op);
+    }
+
+    uint64_t operator()(const std::vector<std::string>& Op)
+    {
+        return index(RegBitFields, Op);
+    }
+
+    uint64_t operator()(const relations::FPImmOp& Op)
+    {
+        return index(FPImm, Op);
+    }
+
+    uint64_t operator()(const relations::IndirectOp& Op)
+    {
+        return index(Indirect, Op);
+    }
+
+    uint64_t operator()(const relations::SpecialOp& Op)
+    {
+        return index(Special, Op);
+    }
+
+private:
+    template <typename T>
+    uint64_t index(std::map<T, uint64_t>& OpTable, const T& Op)
+    {
+        auto [Iter, Inserted] = OpTable.try_emplace(Op, Index);
+        if(Inserted)
+        {
+            Index++;
+        }
+        return Iter->second;
+    }
+
+    uint64_t Index = 1;
+    std::map<relations::ImmOp, uint64_t> Imm;
+    std::map<relations::RegOp, uint64_t> Reg;
+    std::map<std::vector<std::string>, uint64_t> RegBitFields;
+    std::map<relations::FPImmOp, uint64_t> FPImm;
+    std::map<relations::IndirectOp, uint64_t> Indirect;
+    std::map<relations::SpecialOp, uint64_t> Special;
+};
+
+// Operands in the proportions seen when decoding x64 code at every offset: mostly
+// registers, memory operands and small immediates, with many repetitions.
+static std::vector<relations::Operand> buildOperands()
+{
+    const std::vector<std::string> Registers = {"RAX", "RBX", "RCX", "RDX", "RSI", "RDI",
+                                                "RBP", "RSP", "R8",  "R9",  "R12", "NONE",
+                                                "EAX", "ECX", "XMM0", "XMM1"};
+    std::mt19937_64 Random(3);
+    auto Register = [&]() { return Registers[Random() % Registers.size()]; };
+
+    std::vector<relations::Operand> Operands;
+    while(Operands.size() < (1 << 20))
+    {
+        switch(Random() % 4)
+        {
+            case 0:
+            case 1:
+                Operands.push_back(Register());
+                break;
+            case 2:
+                Operands.push_back(relations::IndirectOp{
+                    "NONE", Register(), Register(), static_cast<int64_t>(1 << (Random() % 4)),
+                    static_cast<int64_t>(Random() % 4096) - 2048,
+                    static_cast<uint8_t>(1 << (Random() % 4))});
+                break;
+            default:
+                Operands.push_back(relations::ImmOp{static_cast<int64_t>(Random() % 65536),
+                                                    static_cast<uint8_t>(Random() % 2 * 4)});
+                break;
+        }
+    }
+    return Operands;
+}
+
+DDISASM_BENCHMARK(operand_facts)
+{
+    std::vector<relations::Operand> Operands = buildOperands();
+
+    measure("OperandFacts::add (std::map)", Operands.size(), [&]() {
+        ReferenceOperandFacts Facts;
+        uint64_t Sum = 0;
+        for(const relations::Operand& Op : Operands)
+        {
+            Sum += Facts.add(Op);
+        }
+        return Sum;
+    });
+    measure("OperandFacts::add (hash table)", Operands.size(), [&]() {
+        OperandFacts Facts;
+        uint64_t Sum = 0;
+        for(const relations::Operand& Op : Operands)
+        {
+            Sum += Facts.add(Op);
+        }
+        return Sum;
+    });
+}
+
+DDISASM_BENCHMARK(instruction_load)
+{
+    std::optional<GtirbBuilder::GTIRB> GTIRB = buildX64();
+    if(!GTIRB)
+    {
+        return;
+    }
+    const gtirb::Module& Module = *GTIRB->IR->modules().begin();
+
+    CompositeLoader Loader("souffle_disasm_x86_64");
+    Loader.add<X64Loader>();
+
+    unsigned int Threads = std::max(std::thread::hardware_concurrency(), 1u);
+    for(unsigned int J : {1u, Threads})
+    {
+        auto Start = std::chrono::steady_clock::now();
+        std::unique_ptr<souffle::SouffleProgram> Program = Loader.load(Module, J);
+        std::chrono::duration<double> Elapsed = std::chrono::steady_clock::now() - Start;
+        if(!Program)
+        {
+            std::cerr << "    souffle_disasm_x86_64 is not available\n";
+            return;
+        }
+        BenchmarkSink = BenchmarkSink + Program->getRelation("instruction")->size();
+
+        std::string Label = "load (" + std::to_string(J) + " threads)";
+        std::cout << "    " << std::left << std::setw(48) << Label << std::right << std::setw(12)
+                  << std::fixed << std::setprecision(1) << Elapsed.count() * 1e3 << " ms"
+                  << std::setw(12) << peakMemory() / 1024 << " MiB peak\n";
+    }
+}
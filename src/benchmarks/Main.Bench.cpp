@@ -0,0 +1,40 @@
+#include <iostream>
+#include <string>
+
+#include "../CliDriver.h"
+#include "../Registration.h"
+#include "Benchmark.h"
+
+volatile uint64_t BenchmarkSink = 0;
+
+std::vector<Benchmark>& benchmarks()
+{
+    static std::vector<Benchmark> Benchmarks;
+    return Benchmarks;
+}
+
+uint64_t peakMemory()
+{
+    return getPeakMemoryUsage().value_or(0) / 1024;
+}
+
+// Run the benchmarks whose name contains one of the arguments, or all of them.
+int main(int argc, char** argv)
+{
+    registerAuxDataTypes();
+
+    for(const Benchmark& B : benchmarks())
+    {
+        bool Selected = argc < 2;
+        for(int I = 1; I < argc; I++)
+        {
+            Selected |= B.Name.find(argv[I]) != std::string::npos;
+        }
+        if(Selected)
+        {
+            std::cout << B.Name << "\n";
+            B.Run();
+        }
+    }
+    return 0;
+}
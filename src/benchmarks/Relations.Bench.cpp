@@ -0,0 +1,85 @@
+#include <gtirb/gtirb.hpp>
+#include <iostream>
+#include <string>
+
+#include "../gtirb-decoder/Relations.h"
+#include "../gtirb-decoder/arch/X64Loader.h"
+#include "../gtirb-decoder/core/DataLoader.h"
+#include "Benchmark.h"
+#include "BenchmarkInputs.h"
+
+// Expose the facts that the loaders would insert.
+class X64FactsLoader : public X64Loader
+{
+public:
+    using InstructionLoader::load;
+};
+
+class DataFactsLoader : public DataLoader
+{
+public:
+    DataFactsLoader() : DataLoader(DataLoader::Pointer::QWORD)
+    {
+    }
+    using DataLoader::load;
+};
+
+// Insertion as done before relations::insert reused its tuple.
+template <typename T>
+static void referenceInsert(souffle::SouffleProgram& Program, const std::string& Name,
+                            const T& Data)
+{
+    if(auto* Relation = Program.getRelation(Name))
+    {
+        for(const auto& Element : Data)
+        {
+            souffle::tuple Row(Relation);
+            Row << Element;
+            Relation->insert(Row);
+        }
+    }
+}
+
+template <typename T>
+static void measureInsert(souffle::SouffleProgram& Program, const std::string& Name,
+                          const T& Data)
+{
+    souffle::Relation* Relation = Program.getRelation(Name);
+    measure(Name + " (tuple per row)", Data.size(), [&]() {
+        Relation->purge();
+        referenceInsert(Program, Name, Data);
+        return Relation->size();
+    });
+    measure(Name + " (relations::insert)", Data.size(), [&]() {
+        Relation->purge();
+        relations::insert(Program, Name, Data);
+        return Relation->size();
+    });
+}
+
+DDISASM_BENCHMARK(relation_insert)
+{
+    std::optional<GtirbBuilder::GTIRB> GTIRB = buildX64();
+    if(!GTIRB)
+    {
+        return;
+    }
+    const gtirb::Module& Module = *GTIRB->IR->modules().begin();
+
+    std::unique_ptr<souffle::SouffleProgram> Program(
+        souffle::ProgramFactory::newInstance("souffle_disasm_x86_64"));
+    if(!Program)
+    {
+        std::cerr << "    souffle_disasm_x86_64 is not available\n";
+        return;
+    }
+
+    BinaryFacts Binary;
+    X64FactsLoader().load(Module, Binary);
+    DataFacts Data;
+    DataFactsLoader().load(Module, Data);
+
+    measureInsert(*Program, "instruction", Binary.Instructions.instructions());
+    measureInsert(*Program, "op_indirect", Binary.Operands.indirect());
+    measureInsert(*Program, "address_in_data", Data.Addresses);
+}
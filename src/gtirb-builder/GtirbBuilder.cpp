@@ -22,12 +22,43 @@
 //===----------------------------------------------------------------------===//
 #include "./GtirbBuilder.h"
 
+#include <algorithm>
+
 #include "./ArchiveReader.h"
 #include "./ElfReader.h"
 #include "./PeReader.h"
 
 using GTIRB = GtirbBuilder::GTIRB;
 
+// Build the module of a single archive member into IR.
+static std::error_code buildArchiveMember(ArchiveReader& Archive, ArchiveReaderFile& Object,
+                                          const std::string& Path,
+                                          std::shared_ptr<gtirb::Context> Context, gtirb::IR* IR)
+{
+    std::shared_ptr<LIEF::Binary> Binary;
+    {
+        // LIEF keeps its own copy of the object, so free ours before the
+        // sections are copied to GTIRB.
+        std::vector<uint8_t> ObjectData;
+        Archive.readFile(Object, ObjectData);
+        Binary = LIEF::Parser::parse(ObjectData);
+    }
+
+    if(!Binary)
+    {
+        return GtirbBuilder::build_error::ParseError;
+    }
+
+    if(Binary->format() != LIEF::Binary::FORMATS::ELF)
+    {
+        return GtirbBuilder::build_error::NotSupported;
+    }
+
+    ElfReader Elf(Path, Object.FileName, Context, IR, Binary);
+    Elf.build();
+    return {};
+}
+
 gtirb::ErrorOr<GTIRB> GtirbBuilder::read(std::string Path)
 {
     // Check that the file exists.
@@ -54,6 +85,8 @@ gtirb::ErrorOr<GTIRB> GtirbBuilder::read(std::string Path)
         // If the binary had no sections, parse again with AUTO count method.
         if(LIEF::ELF::is_elf(Path) && Binary->sections().empty())
         {
+            // Release the first parse before holding a second copy of the input.
+            Binary.reset();
             Binary = LIEF::ELF::Parser::parse(Path, LIEF::ELF::ParserConfig{.count_mtd=LIEF::ELF::ParserConfig::DYNSYM_COUNT::AUTO});
         }
 
@@ -96,26 +129,10 @@ gtirb::ErrorOr<GTIRB> GtirbBuilder::read(std::string Path)
 
             for(auto& Object : Archive.Files)
             {
-                std::vector<uint8_t> ObjectData;
-                Archive.readFile(Object, ObjectData);
-
-                std::shared_ptr<LIEF::Binary> Binary{
-                    LIEF::Parser::parse(ObjectData)
-                };
-//                    LIEF::Parser::parse(ObjectData, Object.FileName)};
-
-                if(!Binary)
-                {
-                    return GtirbBuilder::build_error::ParseError;
-                }
-
-                if(Binary->format() != LIEF::Binary::FORMATS::ELF)
+                if(std::error_code Error = buildArchiveMember(Archive, Object, Path, Context, IR))
                 {
-                    return GtirbBuilder::build_error::NotSupported;
+                    return Error;
                 }
-
-                ElfReader Elf(Path, Object.FileName, Context, IR, Binary);
-                Elf.build();
             }
         }
         catch(ArchiveReaderException& e)
@@ -137,6 +154,48 @@ gtirb::ErrorOr<GTIRB> GtirbBuilder::read(std::string Path)
     return GtirbBuilder::build_error::NotSupported;
 }
 
+std::error_code GtirbBuilder::readArchive(const std::string& Path, size_t Window,
+                                          const std::function<void(GTIRB&)>& Callback)
+{
+    if(!fs::exists(Path))
+    {
+        return GtirbBuilder::build_error::FileNotFound;
+    }
+
+    try
+    {
+        ArchiveReader Archive = ArchiveReader::read(Path);
+
+        auto It = Archive.Files.begin();
+        while(It != Archive.Files.end())
+        {
+            // Each window gets its own context, so all of its allocations are
+            // released once the callback returns.
+            auto Context = std::make_shared<gtirb::Context>();
+            gtirb::IR* IR = gtirb::IR::Create(*Context);
+
+            for(size_t Count = 0; Count < std::max<size_t>(Window, 1) && It != Archive.Files.end();
+                ++Count, ++It)
+            {
+                if(std::error_code Error = buildArchiveMember(Archive, *It, Path, Context, IR))
+                {
+                    return Error;
+                }
+            }
+
+            GTIRB Part{Context, IR};
+            Callback(Part);
+        }
+    }
+    catch(ArchiveReaderException& e)
+    {
+        std::cerr << std::endl << "ERROR: " << e.what();
+        return GtirbBuilder::build_error::ParseError;
+    }
+
+    return {};
+}
+
 GtirbBuilder::GtirbBuilder(std::string P, std::string Name, std::shared_ptr<gtirb::Context> Context,
                            gtirb::IR* IR, std::shared_ptr<LIEF::Binary> B)
     : Path(P), Context(Context), IR(IR), Binary(B)
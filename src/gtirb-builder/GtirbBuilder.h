@@ -24,6 +24,8 @@
 #ifndef GTIRB_BUILDER_H_
 #define GTIRB_BUILDER_H_
 
+#include <functional>
+
 #include <LIEF/LIEF.hpp>
 #include <boost/filesystem.hpp>
 #include <gtirb/gtirb.hpp>
@@ -46,6 +48,14 @@ public:
     };
 
     static gtirb::ErrorOr<GTIRB> read(std::string Path);
+
+    /// \brief Build the members of a static archive at most Window at a time.
+    ///
+    /// Every window of members is built into a fresh IR and Context that is
+    /// passed to Callback and released when it returns, so peak memory is
+    /// bounded by the largest window rather than by the whole archive.
+    static std::error_code readArchive(const std::string& Path, size_t Window,
+                                       const std::function<void(GTIRB&)>& Callback);
     virtual void build();
 
     /// \enum build_error
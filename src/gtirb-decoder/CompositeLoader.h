@@ -53,13 +53,16 @@ public:
         Loaders.push_back(T{std::forward<Args>(A)...});
     }
 
-    // Build a SouffleProgram
-    std::unique_ptr<souffle::SouffleProgram> load(const gtirb::Module& Module)
+    // Build a SouffleProgram. Loaders may use up to Threads threads, as reported by the
+    // program's getNumThreads().
+    std::unique_ptr<souffle::SouffleProgram> load(const gtirb::Module& Module,
+                                                  unsigned int Threads = 1)
     {
         std::unique_ptr<souffle::SouffleProgram> Program(
             souffle::ProgramFactory::newInstance(Name));
         if(Program)
         {
+            Program->setNumThreads(Threads);
             operator()(Module, *Program);
         }
         return Program;
@@ -24,9 +24,21 @@
 
 #include <souffle/RamTypes.h>
 
+#include <algorithm>
 #include <fstream>
+#include <iterator>
+#include <limits>
 #include <list>
 #include <map>
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "../Parallel.h"
+
+#if defined(DDISASM_ZLIB)
+#include <zlib.h>
+#endif
 
 #if defined(DDISASM_SOUFFLE_PROFILING)
 #include <souffle/profile/ProfileEvent.h>
@@ -36,6 +48,93 @@
 namespace fs = boost::filesystem;
 #endif
 
+std::optional<DatalogIO::RelationFormat> DatalogIO::parseRelationFormat(const std::string &Name)
+{
+    if(Name == "csv")
+    {
+        return RelationFormat::CSV;
+    }
+    if(Name == "binary")
+    {
+        return RelationFormat::BINARY;
+    }
+    if(Name == "compressed")
+    {
+        return RelationFormat::COMPRESSED_BINARY;
+    }
+    return std::nullopt;
+}
+
+bool DatalogIO::matchGlob(const std::string &Pattern, const std::string &Text)
+{
+    // Greedy matching that backtracks to the last `*' on a mismatch.
+    size_t P = 0, T = 0;
+    size_t StarP = std::string::npos, StarT = 0;
+    while(T < Text.size())
+    {
+        if(P < Pattern.size() && (Pattern[P] == '?' || Pattern[P] == Text[T]))
+        {
+            P++;
+            T++;
+        }
+        else if(P < Pattern.size() && Pattern[P] == '*')
+        {
+            StarP = P++;
+            StarT = T;
+        }
+        else if(StarP != std::string::npos)
+        {
+            P = StarP + 1;
+            T = ++StarT;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    while(P < Pattern.size() && Pattern[P] == '*')
+    {
+        P++;
+    }
+    return P == Pattern.size();
+}
+
+bool DatalogIO::RelationFilter::selects(const std::string &Namespace,
+                                        const std::string &Name) const
+{
+    const std::string QualifiedName = Namespace + "." + Name;
+    auto Matches = [&](const std::string &Pattern) { return matchGlob(Pattern, QualifiedName); };
+    return (Selected.empty() || std::any_of(Selected.begin(), Selected.end(), Matches))
+           && std::none_of(Excluded.begin(), Excluded.end(), Matches);
+}
+
+std::vector<souffle::Relation *> DatalogIO::RelationFilter::select(
+    const std::vector<souffle::Relation *> &Relations, const std::string &Namespace) const
+{
+    if(selectsAll())
+    {
+        return Relations;
+    }
+    std::vector<souffle::Relation *> Result;
+    for(souffle::Relation *Relation : Relations)
+    {
+        if(selects(Namespace, Relation->getName()))
+        {
+            Result.push_back(Relation);
+        }
+    }
+    return Result;
+}
+
+bool DatalogIO::supportsCompression()
+{
+#if defined(DDISASM_ZLIB)
+    return true;
+#else
+    return false;
+#endif
+}
+
 /**
 Create a record from a string and return the record ID.
 */
@@ -297,6 +396,13 @@ void DatalogIO::writeRelation(std::ostream &Stream, souffle::SouffleProgram &Pro
 {
     Stream << std::showbase;
 
+    // Look up the attribute types once, rather than for every field.
+    std::vector<std::string> AttrTypes;
+    for(size_t I = 0; I < Relation->getArity(); I++)
+    {
+        AttrTypes.push_back(Relation->getAttrType(I));
+    }
+
     for(souffle::tuple Tuple : *Relation)
     {
         for(size_t I = 0; I < Tuple.size(); I++)
@@ -305,35 +411,563 @@ void DatalogIO::writeRelation(std::ostream &Stream, souffle::SouffleProgram &Pro
             {
                 Stream << "\t";
             }
-            serializeAttribute(Stream, Program, Relation->getAttrType(I), Tuple[I]);
+            serializeAttribute(Stream, Program, AttrTypes[I], Tuple[I]);
         }
         Stream << "\n";
     }
 }
 
+// Header of the binary relation files: magic, version, flags, and two reserved bytes.
+static const char BinaryRelationMagic[4] = {'D', 'D', 'R', 'B'};
+static const uint8_t BinaryRelationVersion = 1;
+static const uint8_t BinaryRelationCompressed = 1;
+static const size_t BinaryRelationHeaderSize = 8;
+
+template <typename T>
+static void putLittleEndian(std::string &Buffer, T Value)
+{
+    for(size_t I = 0; I < sizeof(T); I++)
+    {
+        Buffer.push_back(static_cast<char>((static_cast<uint64_t>(Value) >> (8 * I)) & 0xff));
+    }
+}
+
+// Sizes and indices stored in 32-bit fields must fit rather than wrap.
+static uint32_t toUint32(size_t Value, const char *What)
+{
+    if(Value > std::numeric_limits<uint32_t>::max())
+    {
+        throw std::length_error(std::string("Binary relation ") + What + " exceeds 32 bits");
+    }
+    return static_cast<uint32_t>(Value);
+}
+
+static void putString(std::string &Buffer, const std::string &Value)
+{
+    putLittleEndian<uint32_t>(Buffer, toUint32(Value.size(), "string size"));
+    Buffer.append(Value);
+}
+
+#if defined(DDISASM_ZLIB)
+// Largest buffer zlib takes at once.
+static const size_t MaxZlibChunk = std::numeric_limits<uInt>::max();
+#endif
+
+/**
+Bounds-checked reader of the body of a binary relation.
+*/
+class BinaryRelationReader
+{
+public:
+    explicit BinaryRelationReader(const std::string &Data) : Data(Data)
+    {
+    }
+
+    template <typename T>
+    bool get(T &Value)
+    {
+        if(Data.size() - Pos < sizeof(T))
+        {
+            return false;
+        }
+        uint64_t Bits = 0;
+        for(size_t I = 0; I < sizeof(T); I++)
+        {
+            Bits |= static_cast<uint64_t>(static_cast<uint8_t>(Data[Pos++])) << (8 * I);
+        }
+        Value = static_cast<T>(Bits);
+        return true;
+    }
+
+    bool getString(std::string &Value)
+    {
+        uint32_t Size;
+        if(!get(Size) || Data.size() - Pos < Size)
+        {
+            return false;
+        }
+        Value = Data.substr(Pos, Size);
+        Pos += Size;
+        return true;
+    }
+
+    size_t remaining() const
+    {
+        return Data.size() - Pos;
+    }
+
+    size_t position() const
+    {
+        return Pos;
+    }
+
+private:
+    const std::string &Data;
+    size_t Pos = 0;
+};
+
+/**
+Writes the body of a binary relation to a stream, compressed if requested and supported.
+*/
+class BinaryRelationSink
+{
+public:
+    BinaryRelationSink(std::ostream &Stream, bool Compress) : Stream(Stream)
+    {
+#if defined(DDISASM_ZLIB)
+        Compressed = Compress && deflateInit(&ZStream, Z_DEFAULT_COMPRESSION) == Z_OK;
+#else
+        (void)Compress;
+#endif
+    }
+
+    bool compressed() const
+    {
+        return Compressed;
+    }
+
+    void write(const std::string &Data)
+    {
+#if defined(DDISASM_ZLIB)
+        if(Compressed)
+        {
+            for(size_t Pos = 0; Pos < Data.size(); Pos += MaxZlibChunk)
+            {
+                ZStream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(Data.data() + Pos));
+                ZStream.avail_in = static_cast<uInt>(std::min(Data.size() - Pos, MaxZlibChunk));
+                deflateAll(Z_NO_FLUSH);
+            }
+            return;
+        }
+#endif
+        Stream.write(Data.data(), static_cast<std::streamsize>(Data.size()));
+    }
+
+    void finish()
+    {
+#if defined(DDISASM_ZLIB)
+        if(Compressed)
+        {
+            ZStream.avail_in = 0;
+            deflateAll(Z_FINISH);
+            deflateEnd(&ZStream);
+        }
+#endif
+    }
+
+private:
+    std::ostream &Stream;
+    bool Compressed = false;
+
+#if defined(DDISASM_ZLIB)
+    void deflateAll(int Flush)
+    {
+        char Out[1 << 16];
+        int Status;
+        do
+        {
+            ZStream.next_out = reinterpret_cast<Bytef *>(Out);
+            ZStream.avail_out = sizeof(Out);
+            Status = deflate(&ZStream, Flush);
+            Stream.write(Out, static_cast<std::streamsize>(sizeof(Out) - ZStream.avail_out));
+        } while(ZStream.avail_out == 0 || (Flush == Z_FINISH && Status != Z_STREAM_END));
+    }
+
+    z_stream ZStream{};
+#endif
+};
+
+static std::optional<std::string> inflateBinaryRelation(const std::string &Data)
+{
+#if defined(DDISASM_ZLIB)
+    z_stream ZStream{};
+    if(inflateInit(&ZStream) != Z_OK)
+    {
+        return std::nullopt;
+    }
+
+    std::string Result;
+    char Out[1 << 16];
+    size_t Pos = 0;
+    int Status;
+    do
+    {
+        if(ZStream.avail_in == 0 && Pos < Data.size())
+        {
+            ZStream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(Data.data() + Pos));
+            ZStream.avail_in = static_cast<uInt>(std::min(Data.size() - Pos, MaxZlibChunk));
+            Pos += ZStream.avail_in;
+        }
+        ZStream.next_out = reinterpret_cast<Bytef *>(Out);
+        ZStream.avail_out = sizeof(Out);
+        Status = inflate(&ZStream, Z_NO_FLUSH);
+        Result.append(Out, sizeof(Out) - ZStream.avail_out);
+    } while(Status == Z_OK);
+    inflateEnd(&ZStream);
+    if(Status != Z_STREAM_END)
+    {
+        return std::nullopt;
+    }
+    return Result;
+#else
+    (void)Data;
+    std::cerr << "Error: ddisasm was built without zlib, cannot read compressed relations\n";
+    return std::nullopt;
+#endif
+}
+
+void DatalogIO::writeBinaryRelation(std::ostream &Stream, souffle::SouffleProgram &Program,
+                                    const souffle::Relation *Relation, bool Compress)
+{
+    size_t Arity = Relation->getArity();
+    souffle::SymbolTable &SymbolTable = Program.getSymbolTable();
+
+    // Symbols and records are stored as their text in a table shared by all columns.
+    std::vector<std::string> Texts;
+    std::unordered_map<souffle::RamDomain, uint32_t> SymbolIndices;
+    std::unordered_map<std::string, uint32_t> RecordIndices;
+    auto addText = [&Texts](const std::string &Text) {
+        Texts.push_back(Text);
+        return toUint32(Texts.size() - 1, "text index");
+    };
+
+    // Look up the attribute types once, rather than for every field.
+    std::vector<std::string> AttrTypes;
+    for(size_t I = 0; I < Arity; I++)
+    {
+        AttrTypes.push_back(Relation->getAttrType(I));
+    }
+
+    std::vector<std::string> Columns(Arity);
+    uint64_t Count = 0;
+    for(souffle::tuple Tuple : *Relation)
+    {
+        for(size_t I = 0; I < Arity; I++)
+        {
+            switch(AttrTypes[I][0])
+            {
+                case 's':
+                {
+                    auto [It, Inserted] = SymbolIndices.try_emplace(Tuple[I], 0);
+                    if(Inserted)
+                    {
+                        It->second = addText(SymbolTable.unsafeDecode(Tuple[I]));
+                    }
+                    putLittleEndian<uint32_t>(Columns[I], It->second);
+                    break;
+                }
+                case 'r':
+                {
+                    std::stringstream Record;
+                    serializeRecord(Record, Program, AttrTypes[I], Tuple[I]);
+                    auto [It, Inserted] = RecordIndices.try_emplace(Record.str(), 0);
+                    if(Inserted)
+                    {
+                        It->second = addText(Record.str());
+                    }
+                    putLittleEndian<uint32_t>(Columns[I], It->second);
+                    break;
+                }
+                default:
+                    putLittleEndian<uint64_t>(Columns[I],
+                                              souffle::ramBitCast<souffle::RamUnsigned>(Tuple[I]));
+            }
+        }
+        Count++;
+    }
+
+    std::string Table;
+    putLittleEndian<uint32_t>(Table, toUint32(Arity, "arity"));
+    putLittleEndian<uint64_t>(Table, Count);
+    for(size_t I = 0; I < Arity; I++)
+    {
+        putString(Table, Relation->getAttrName(I));
+        putString(Table, AttrTypes[I]);
+    }
+    putLittleEndian<uint32_t>(Table, toUint32(Texts.size(), "text count"));
+    for(const std::string &Text : Texts)
+    {
+        putString(Table, Text);
+    }
+
+    BinaryRelationSink Sink(Stream, Compress);
+    std::string Header(BinaryRelationMagic, sizeof(BinaryRelationMagic));
+    Header.push_back(static_cast<char>(BinaryRelationVersion));
+    Header.push_back(static_cast<char>(Sink.compressed() ? BinaryRelationCompressed : 0));
+    Header.append(BinaryRelationHeaderSize - Header.size(), '\0');
+    Stream.write(Header.data(), static_cast<std::streamsize>(Header.size()));
+
+    Sink.write(Table);
+    for(std::string &Column : Columns)
+    {
+        Sink.write(Column);
+        Column = std::string();
+    }
+    Sink.finish();
+}
+
+bool DatalogIO::readBinaryRelation(std::istream &Stream, souffle::SouffleProgram &Program,
+                                   souffle::Relation *Relation)
+{
+    std::string Data((std::istreambuf_iterator<char>(Stream)), std::istreambuf_iterator<char>());
+    if(Data.size() < BinaryRelationHeaderSize
+       || Data.compare(0, sizeof(BinaryRelationMagic), BinaryRelationMagic,
+                       sizeof(BinaryRelationMagic))
+              != 0)
+    {
+        std::cerr << "Error: not a binary relation: " << Relation->getName() << "\n";
+        return false;
+    }
+    uint8_t Version = static_cast<uint8_t>(Data[4]);
+    uint8_t Flags = static_cast<uint8_t>(Data[5]);
+    if(Version != BinaryRelationVersion)
+    {
+        std::cerr << "Error: unsupported binary relation version " << unsigned(Version) << ": "
+                  << Relation->getName() << "\n";
+        return false;
+    }
+    Data.erase(0, BinaryRelationHeaderSize);
+    if(Flags & BinaryRelationCompressed)
+    {
+        std::optional<std::string> Inflated = inflateBinaryRelation(Data);
+        if(!Inflated)
+        {
+            std::cerr << "Error: corrupt binary relation: " << Relation->getName() << "\n";
+            return false;
+        }
+        Data = std::move(*Inflated);
+    }
+
+    BinaryRelationReader Reader(Data);
+    uint32_t Arity;
+    uint64_t Count;
+    if(!Reader.get(Arity) || !Reader.get(Count) || Arity != Relation->getArity())
+    {
+        std::cerr << "Error: arity mismatch in binary relation: " << Relation->getName() << "\n";
+        return false;
+    }
+    std::vector<char> Kinds;
+    std::vector<size_t> Widths;
+    for(size_t I = 0; I < Arity; I++)
+    {
+        std::string Name, Type;
+        if(!Reader.getString(Name) || !Reader.getString(Type) || Type != Relation->getAttrType(I))
+        {
+            std::cerr << "Error: type mismatch in binary relation: " << Relation->getName()
+                      << "\n";
+            return false;
+        }
+        Kinds.push_back(Type[0]);
+        Widths.push_back(Type[0] == 's' || Type[0] == 'r' ? 4 : 8);
+    }
+    uint32_t TextCount;
+    std::vector<std::string> Texts;
+    bool Valid = Reader.get(TextCount);
+    for(uint32_t I = 0; Valid && I < TextCount; I++)
+    {
+        Texts.emplace_back();
+        Valid = Reader.getString(Texts.back());
+    }
+
+    // The columns follow the table, one after another.
+    size_t Size = 0;
+    for(size_t Width : Widths)
+    {
+        Size += Width * Count;
+    }
+    if(!Valid || (Arity > 0 && Count > Reader.remaining()) || Size != Reader.remaining())
+    {
+        std::cerr << "Error: truncated binary relation: " << Relation->getName() << "\n";
+        return false;
+    }
+    std::vector<size_t> Offsets;
+    size_t Offset = Reader.position();
+    for(size_t Width : Widths)
+    {
+        Offsets.push_back(Offset);
+        Offset += Width * Count;
+    }
+
+    souffle::SymbolTable &SymbolTable = Program.getSymbolTable();
+    std::vector<std::optional<souffle::RamDomain>> Symbols(Texts.size());
+    for(uint64_t Row = 0; Row < Count; Row++)
+    {
+        souffle::tuple T(Relation);
+        for(size_t I = 0; I < Arity; I++)
+        {
+            uint64_t Value = 0;
+            for(size_t B = 0; B < Widths[I]; B++)
+            {
+                Value |= static_cast<uint64_t>(static_cast<uint8_t>(Data[Offsets[I]++])) << (8 * B);
+            }
+            char Kind = Kinds[I];
+            if((Kind == 's' || Kind == 'r') && Value >= Texts.size())
+            {
+                std::cerr << "Error: bad symbol in binary relation: " << Relation->getName()
+                          << "\n";
+                return false;
+            }
+            if(Kind == 's')
+            {
+                if(!Symbols[Value])
+                {
+                    Symbols[Value] = SymbolTable.encode(Texts[Value]);
+                }
+                T[I] = *Symbols[Value];
+            }
+            else if(Kind == 'r')
+            {
+                T[I] = insertRecord(Program, Texts[Value]);
+            }
+            else
+            {
+                T[I] = souffle::ramBitCast(static_cast<souffle::RamUnsigned>(Value));
+            }
+        }
+        Relation->insert(T);
+    }
+    return true;
+}
+
+bool DatalogIO::compatibleRelations(const souffle::Relation *From, const souffle::Relation *To)
+{
+    if(From->getArity() != To->getArity())
+    {
+        return false;
+    }
+    for(size_t I = 0; I < From->getArity(); I++)
+    {
+        // Attribute types are qualified by their kind, e.g., "s:symbol" or "u:address".
+        char Kind = From->getAttrType(I)[0];
+        bool Primitive = Kind == 's' || Kind == 'i' || Kind == 'u' || Kind == 'f';
+        if(!Primitive || Kind != To->getAttrType(I)[0])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+DatalogIO::SavedRelation DatalogIO::saveRelation(const souffle::Relation *Relation)
+{
+    SavedRelation Saved{Relation, {}};
+    Saved.Values.reserve(Relation->size() * Relation->getArity());
+    for(souffle::tuple Tuple : *Relation)
+    {
+        for(size_t I = 0; I < Tuple.size(); I++)
+        {
+            Saved.Values.push_back(Tuple[I]);
+        }
+    }
+    return Saved;
+}
+
+void DatalogIO::copyRelation(souffle::SouffleProgram &FromProgram, const SavedRelation &From,
+                             souffle::SouffleProgram &ToProgram, souffle::Relation *To,
+                             const TupleFilter &Filter)
+{
+    size_t Arity = From.Relation->getArity();
+    std::vector<bool> Symbols;
+    for(size_t I = 0; I < Arity; I++)
+    {
+        Symbols.push_back(From.Relation->getAttrType(I)[0] == 's');
+    }
+
+    // Relations typically repeat a few symbols, so each is translated only once.
+    souffle::SymbolTable &FromSymbols = FromProgram.getSymbolTable();
+    souffle::SymbolTable &ToSymbols = ToProgram.getSymbolTable();
+    std::unordered_map<souffle::RamDomain, souffle::RamDomain> Translated;
+
+    for(size_t Offset = 0; Arity > 0 && Offset < From.Values.size(); Offset += Arity)
+    {
+        const souffle::RamDomain *Values = &From.Values[Offset];
+        if(Filter && !Filter(Values))
+        {
+            continue;
+        }
+        souffle::tuple Row(To);
+        for(size_t I = 0; I < Arity; I++)
+        {
+            souffle::RamDomain Value = Values[I];
+            if(Symbols[I])
+            {
+                auto [It, Inserted] = Translated.try_emplace(Value, 0);
+                if(Inserted)
+                {
+                    It->second = ToSymbols.encode(FromSymbols.decode(Value));
+                }
+                Value = It->second;
+            }
+            Row[I] = Value;
+        }
+        To->insert(Row);
+    }
+}
+
 void DatalogIO::writeRelations(const std::string &Directory, const std::string &FileExtension,
                                souffle::SouffleProgram &Program,
-                               const std::vector<souffle::Relation *> &Relations)
+                               const std::vector<souffle::Relation *> &Relations,
+                               RelationFormat Format, unsigned int Threads)
 {
-    std::ios_base::openmode FileMask = std::ios::out;
-    for(souffle::Relation *Relation : Relations)
-    {
-        std::ofstream File(Directory + Relation->getName() + FileExtension, FileMask);
-        writeRelation(File, Program, Relation);
+    // Relation sizes differ by orders of magnitude: hand out the largest first, so that no
+    // worker is left with a large relation once the others are done.
+    std::vector<souffle::Relation *> Sorted(Relations);
+    std::stable_sort(Sorted.begin(), Sorted.end(),
+                     [](const souffle::Relation *A, const souffle::Relation *B) {
+                         return A->size() > B->size();
+                     });
+
+    // Each worker writes its files through one large buffer of its own.
+    const size_t FileBufferSize = 1 << 20;
+    std::vector<std::vector<char>> Buffers(std::max(Threads, 1u));
+
+    parallelForWorkers(Sorted.size(), Threads, [&](size_t Worker, size_t Index) {
+        souffle::Relation *Relation = Sorted[Index];
+        std::vector<char> &Buffer = Buffers[Worker];
+        Buffer.resize(FileBufferSize);
+
+        std::ios_base::openmode FileMask = std::ios::out;
+        if(Format != RelationFormat::CSV)
+        {
+            FileMask |= std::ios::binary;
+        }
+        std::ofstream File;
+        File.rdbuf()->pubsetbuf(Buffer.data(), static_cast<std::streamsize>(Buffer.size()));
+        File.open(Directory + Relation->getName() + FileExtension, FileMask);
+        if(Format == RelationFormat::CSV)
+        {
+            writeRelation(File, Program, Relation);
+        }
+        else
+        {
+            writeBinaryRelation(File, Program, Relation,
+                                Format == RelationFormat::COMPRESSED_BINARY);
+        }
         File.close();
-    }
+    });
 }
 
-void DatalogIO::writeFacts(const std::string &Directory, souffle::SouffleProgram &Program)
+void DatalogIO::writeFacts(const std::string &Directory, souffle::SouffleProgram &Program,
+                           RelationFormat Format, unsigned int Threads,
+                           const RelationFilter &Filter, const std::string &Namespace)
 {
-    writeRelations(Directory, ".facts", Program, Program.getInputRelations());
+    std::string FileExtension = Format == RelationFormat::CSV ? ".facts" : ".facts.bin";
+    writeRelations(Directory, FileExtension, Program,
+                   Filter.select(Program.getInputRelations(), Namespace), Format, Threads);
 }
 
-void DatalogIO::writeRelations(const std::string &Directory, souffle::SouffleProgram &Program)
+void DatalogIO::writeRelations(const std::string &Directory, souffle::SouffleProgram &Program,
+                               RelationFormat Format, unsigned int Threads,
+                               const RelationFilter &Filter, const std::string &Namespace)
 {
-    std::string FileExtension = ".csv";
-    writeRelations(Directory, FileExtension, Program, Program.getInternalRelations());
-    writeRelations(Directory, FileExtension, Program, Program.getOutputRelations());
+    std::string FileExtension = Format == RelationFormat::CSV ? ".csv" : ".bin";
+    std::vector<souffle::Relation *> Relations = Program.getInternalRelations();
+    for(souffle::Relation *Relation : Program.getOutputRelations())
+    {
+        Relations.push_back(Relation);
+    }
+    writeRelations(Directory, FileExtension, Program, Filter.select(Relations, Namespace),
+                   Format, Threads);
 }
 
 void DatalogIO::readRelations(souffle::SouffleProgram &Program, const std::string &Directory)
@@ -345,7 +979,16 @@ void DatalogIO::readRelations(souffle::SouffleProgram &Program, const std::strin
         std::ifstream CSV(Path);
         if(!CSV)
         {
-            std::cerr << "Error: missing output relation `" << Path << "'\n";
+            const std::string BinaryPath = Directory + "/" + Relation->getName() + ".bin";
+            std::ifstream Binary(BinaryPath, std::ios::in | std::ios::binary);
+            if(!Binary)
+            {
+                std::cerr << "Error: missing output relation `" << Path << "'\n";
+            }
+            else
+            {
+                DatalogIO::readBinaryRelation(Binary, Program, Relation);
+            }
             continue;
         }
         std::string Line;
@@ -356,6 +999,15 @@ void DatalogIO::readRelations(souffle::SouffleProgram &Program, const std::strin
     }
 }
 
+bool DatalogIO::hasProfiling()
+{
+#if defined(DDISASM_SOUFFLE_PROFILING)
+    return true;
+#else
+    return false;
+#endif
+}
+
 void DatalogIO::setProfilePath(const std::string &ProfilePath)
 {
 #if defined(DDISASM_SOUFFLE_PROFILING)
@@ -26,13 +26,71 @@
 #include <souffle/CompiledSouffle.h>
 #include <souffle/SouffleInterface.h>
 
+#include <functional>
 #include <memory>
+#include <optional>
 #include <sstream>
 #include <string>
 #include <tuple>
+#include <vector>
 
 namespace DatalogIO
 {
+    /**
+    Format of the relation files written to the debug directory.
+
+    BINARY files hold a header, a table of the symbols and records of the relation, and one
+    column per attribute: 32-bit indices into the table for symbols and records, and 64-bit
+    values for the other attributes, all little-endian. COMPRESSED_BINARY files compress
+    everything after the header with zlib, if ddisasm was built with it.
+    */
+    enum class RelationFormat
+    {
+        CSV,
+        BINARY,
+        COMPRESSED_BINARY,
+    };
+
+    // Parse the name of a format: "csv", "binary", or "compressed".
+    std::optional<RelationFormat> parseRelationFormat(const std::string& Name);
+
+    // Whether ddisasm was built with zlib, which COMPRESSED_BINARY needs.
+    bool supportsCompression();
+
+    // Whether Text matches a glob Pattern, where `*' matches any sequence of characters and
+    // `?' any single character.
+    bool matchGlob(const std::string& Pattern, const std::string& Text);
+
+    /**
+    Selection of relations by glob patterns matching their names, qualified with the name
+    slug of their pass: e.g. "disassembly.symbolic_operand", "*.value_reg" or
+    "no-return-analysis.*". A relation is selected if it matches any of the selected
+    patterns, or there are none, and none of the excluded patterns.
+    */
+    class RelationFilter
+    {
+    public:
+        void select(const std::string& Pattern)
+        {
+            Selected.push_back(Pattern);
+        }
+        void exclude(const std::string& Pattern)
+        {
+            Excluded.push_back(Pattern);
+        }
+        bool selectsAll() const
+        {
+            return Selected.empty() && Excluded.empty();
+        }
+        bool selects(const std::string& Namespace, const std::string& Name) const;
+        std::vector<souffle::Relation*> select(const std::vector<souffle::Relation*>& Relations,
+                                               const std::string& Namespace) const;
+
+    private:
+        std::vector<std::string> Selected;
+        std::vector<std::string> Excluded;
+    };
+
     void serializeRecord(std::ostream& Stream, souffle::SouffleProgram& Program,
                          const std::string& AttrType, souffle::RamDomain RecordId);
     void serializeAttribute(std::ostream& Stream, souffle::SouffleProgram& Program,
@@ -48,15 +106,66 @@ namespace DatalogIO
     void writeRelation(std::ostream& Stream, souffle::SouffleProgram& Program,
                        const souffle::Relation* Relation);
 
+    void writeBinaryRelation(std::ostream& Stream, souffle::SouffleProgram& Program,
+                             const souffle::Relation* Relation, bool Compress);
+
+    // Insert the tuples of a relation written by writeBinaryRelation. Returns false, leaving
+    // Relation unchanged, if the stream is not a binary relation with the types of Relation.
+    bool readBinaryRelation(std::istream& Stream, souffle::SouffleProgram& Program,
+                            souffle::Relation* Relation);
+
+    // Whether tuples of From can be copied to To: both have the same arity, and attributes of
+    // the same primitive kind. Records and ADTs are not supported.
+    bool compatibleRelations(const souffle::Relation* From, const souffle::Relation* To);
+
+    /**
+    Tuples of a relation saved from its program, e.g. before Souffle purges the relation
+    during a run. The values of the tuples are stored one tuple after the other, with the
+    symbols encoded in the symbol table of the program.
+    */
+    struct SavedRelation
+    {
+        const souffle::Relation* Relation = nullptr;
+        std::vector<souffle::RamDomain> Values;
+    };
+
+    SavedRelation saveRelation(const souffle::Relation* Relation);
+
+    // Selects tuples by the values of their attributes.
+    using TupleFilter = std::function<bool(const souffle::RamDomain* Tuple)>;
+
+    // Copy the saved tuples accepted by Filter (or all of them, if Filter is empty) into a
+    // compatible relation of another program, translating symbols from the symbol table of
+    // FromProgram, which saved them, to that of ToProgram.
+    void copyRelation(souffle::SouffleProgram& FromProgram, const SavedRelation& From,
+                      souffle::SouffleProgram& ToProgram, souffle::Relation* To,
+                      const TupleFilter& Filter);
+
+    // Write each relation to the file with its name and FileExtension, on up to Threads
+    // threads.
     void writeRelations(const std::string& Directory, const std::string& FileExtension,
                         souffle::SouffleProgram& Program,
-                        const std::vector<souffle::Relation*>& Relations);
+                        const std::vector<souffle::Relation*>& Relations,
+                        RelationFormat Format = RelationFormat::CSV, unsigned int Threads = 1);
 
-    void writeFacts(const std::string& Direcory, souffle::SouffleProgram& Program);
-    void writeRelations(const std::string& Directory, souffle::SouffleProgram& Program);
+    // Write the input relations, or the internal and output relations, selected by Filter
+    // for the pass with the name slug Namespace.
+    void writeFacts(const std::string& Direcory, souffle::SouffleProgram& Program,
+                    RelationFormat Format = RelationFormat::CSV, unsigned int Threads = 1,
+                    const RelationFilter& Filter = RelationFilter(),
+                    const std::string& Namespace = std::string());
+    void writeRelations(const std::string& Directory, souffle::SouffleProgram& Program,
+                        RelationFormat Format = RelationFormat::CSV, unsigned int Threads = 1,
+                        const RelationFilter& Filter = RelationFilter(),
+                        const std::string& Namespace = std::string());
 
+    // Read the output relations from the ".csv" files, or the ".bin" files written by
+    // writeRelations in a binary format.
     void readRelations(souffle::SouffleProgram& Program, const std::string& Directory);
 
+    // Whether the synthesized programs were built with Souffle profiling, and record into the
+    // global profile database of Souffle even without a profile path.
+    bool hasProfiling();
     void setProfilePath(const std::string& ProfilePath);
     std::string clearProfileDB();
 }; // namespace DatalogIO
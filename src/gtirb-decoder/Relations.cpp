@@ -210,7 +210,7 @@ namespace souffle
 
     souffle::tuple& operator<<(souffle::tuple& T, const relations::RegisterAccess& Access)
     {
-        T << Access.Addr << Access.Register << Access.Mode;
+        T << Access.Addr << std::string(Access.Register) << std::string(Access.Mode);
         return T;
     }
 
@@ -29,6 +29,7 @@
 #include <gtirb/gtirb.hpp>
 #include <map>
 #include <string>
+#include <string_view>
 #include <tuple>
 #include <utility>
 #include <vector>
@@ -42,9 +43,11 @@ namespace relations
     {
         if(auto* Relation = Program.getRelation(Name))
         {
+            // Reuse one tuple for every row, rather than allocating its storage per row.
+            souffle::tuple Row(Relation);
             for(const auto& Element : Data)
             {
-                souffle::tuple Row(Relation);
+                Row.rewind();
                 Row << Element;
                 Relation->insert(Row);
             }
@@ -272,11 +275,13 @@ namespace relations
         std::string CC;
     };
 
+    // Mode and Register refer to string literals or RegisterNames tables, which outlive the
+    // facts.
     struct RegisterAccess
     {
         gtirb::Addr Addr;
-        std::string Mode;
-        std::string Register;
+        std::string_view Mode;
+        std::string_view Register;
     };
 
     struct InstructionOpAccess
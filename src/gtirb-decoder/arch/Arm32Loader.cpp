@@ -271,7 +271,7 @@ bool Arm32Loader::collectOpndFacts(OpndFactsT& OpndFacts, const cs_insn& CsInst)
         Name = Name.substr(0, index);
 
     auto registerName = [this](uint64_t Reg) {
-        return (Reg == ARM_REG_INVALID) ? "NONE" : uppercase(cs_reg_name(*CsHandle, Reg));
+        return std::string((*Registers)[static_cast<unsigned int>(Reg)]);
     };
 
     static std::set<arm_insn> LdmStm = {
@@ -471,7 +471,7 @@ std::optional<relations::Operand> Arm32Loader::build(const cs_insn& CsInsn, cons
     using namespace relations;
 
     auto registerName = [this](uint64_t Reg) {
-        return (Reg == ARM_REG_INVALID) ? "NONE" : uppercase(cs_reg_name(*CsHandle, Reg));
+        return std::string((*Registers)[static_cast<unsigned int>(Reg)]);
     };
 
     switch(CsOp.type)
@@ -40,9 +40,17 @@ public:
         [[maybe_unused]] cs_err Err = cs_open(CS_ARCH_ARM, (cs_mode)(CS_MODE_ARM), CsHandle.get());
         assert(Err == CS_ERR_OK && "Failed to initialize ARM disassembler.");
         cs_option(*CsHandle, CS_OPT_DETAIL, CS_OPT_ON);
+        Registers = &RegisterNames::get(*CsHandle, CS_ARCH_ARM, ARM_REG_ENDING);
     }
 
 protected:
+    std::unique_ptr<InstructionLoader> clone() const override
+    {
+        auto Loader = std::make_unique<Arm32Loader>();
+        Loader->CsModes = CsModes;
+        return Loader;
+    }
+
     // override from CodeBlockLoader
     void load(const gtirb::Module& Module, BinaryFacts& Facts) override
     {
@@ -52,6 +60,19 @@ protected:
 
     void load(const gtirb::Module& Module, const gtirb::ByteInterval& ByteInterval,
               BinaryFacts& Facts) override;
+
+    // Every execution mode is decoded over the whole byte interval, so byte intervals are
+    // never split into smaller ranges.
+    void split(const gtirb::ByteInterval& ByteInterval, std::vector<DecodeRange>& Ranges) override
+    {
+        Ranges.push_back(DecodeRange{&ByteInterval, 0, ByteInterval.getInitializedSize()});
+    }
+    void loadRange(const gtirb::Module& Module, const DecodeRange& Range,
+                   BinaryFacts& Facts) override
+    {
+        load(Module, *Range.ByteInterval, Facts);
+    }
+
     void load(const gtirb::ByteInterval& ByteInterval, BinaryFacts& Facts, size_t ExecutionMode,
               const std::vector<size_t>& CsModes);
     void decode([[maybe_unused]] BinaryFacts& Facts, [[maybe_unused]] const uint8_t* Bytes,
@@ -172,7 +172,7 @@ std::optional<relations::Operand> Arm64Loader::build(const cs_insn& CsInsn, uint
     using namespace relations;
 
     auto registerName = [this](unsigned int Reg) {
-        return (Reg == ARM_REG_INVALID) ? "NONE" : uppercase(cs_reg_name(*CsHandle, Reg));
+        return std::string((*Registers)[Reg]);
     };
 
     switch(CsOp.type)
@@ -40,9 +40,15 @@ public:
         [[maybe_unused]] cs_err Err = cs_open(CS_ARCH_ARM64, CS_MODE_ARM, CsHandle.get());
         assert(Err == CS_ERR_OK && "Failed to initialize ARM64 disassembler.");
         cs_option(*CsHandle, CS_OPT_DETAIL, CS_OPT_ON);
+        Registers = &RegisterNames::get(*CsHandle, CS_ARCH_ARM64, ARM64_REG_ENDING);
     }
 
 protected:
+    std::unique_ptr<InstructionLoader> clone() const override
+    {
+        return std::make_unique<Arm64Loader>();
+    }
+
     void decode(BinaryFacts& Facts, const uint8_t* Bytes, uint64_t Size, uint64_t Addr) override;
     uint8_t operandCount(const cs_insn& CsInstruction) override;
     uint8_t operandAccess(const cs_insn& CsInstruction, uint64_t Index) override;
@@ -41,7 +41,7 @@ public:
         BIG
     };
 
-    Mips32Loader(Endian E = Endian::BIG) : InstructionLoader{4}
+    Mips32Loader(Endian E = Endian::BIG) : InstructionLoader{4}, Endianness{E}
     {
         // Setup Capstone engine.
         unsigned int Mode0 = CS_MODE_MIPS32;
@@ -54,9 +54,15 @@ public:
         [[maybe_unused]] cs_err Err = cs_open(CS_ARCH_MIPS, Mode, CsHandle.get());
         assert(Err == CS_ERR_OK && "Failed to initialize MIPS32 disassembler.");
         cs_option(*CsHandle, CS_OPT_DETAIL, CS_OPT_ON);
+        Registers = &RegisterNames::get(*CsHandle, CS_ARCH_MIPS, MIPS_REG_ENDING);
     }
 
 protected:
+    std::unique_ptr<InstructionLoader> clone() const override
+    {
+        return std::make_unique<Mips32Loader>(Endianness);
+    }
+
     void decode(BinaryFacts& Facts, const uint8_t* Bytes, uint64_t Size, uint64_t Addr) override;
     uint8_t operandCount(const cs_insn& CsInstruction) override;
     uint8_t operandAccess(const cs_insn& CsInstruction, uint64_t Index) override;
@@ -65,6 +71,8 @@ private:
     std::optional<relations::Operand> build(const cs_mips_op& CsOp);
     std::optional<relations::Instruction> build(BinaryFacts& Facts, const cs_insn& CsInstruction);
     std::tuple<std::string, std::string> splitMnemonic(const cs_insn& CsInstruction);
+
+    Endian Endianness;
 };
 
 #endif // SRC_GTIRB_DECODER_ARCH_MIPS32DECODER_H_
@@ -41,9 +41,15 @@ public:
         [[maybe_unused]] cs_err Err = cs_open(CS_ARCH_X86, CS_MODE_64, CsHandle.get());
         assert(Err == CS_ERR_OK && "Failed to initialize X64 disassembler.");
         cs_option(*CsHandle, CS_OPT_DETAIL, CS_OPT_ON);
+        Registers = &RegisterNames::get(*CsHandle, CS_ARCH_X86, X86_REG_ENDING);
     }
 
 protected:
+    std::unique_ptr<InstructionLoader> clone() const override
+    {
+        return std::make_unique<X64Loader>();
+    }
+
     void decode(BinaryFacts& Facts, const uint8_t* Bytes, uint64_t Size, uint64_t Addr) override;
     uint8_t operandCount(const cs_insn& CsInstruction) override;
     uint8_t operandAccess(const cs_insn& CsInstruction, uint64_t Index) override;
@@ -115,7 +115,7 @@ std::tuple<std::string, std::string> X86Loader::splitMnemonic(const cs_insn& CsI
 std::optional<relations::Operand> X86Loader::build(const cs_x86_op& CsOp)
 {
     auto registerName = [this](unsigned int Reg) {
-        return (Reg == X86_REG_INVALID) ? "NONE" : uppercase(cs_reg_name(*CsHandle, Reg));
+        return std::string((*Registers)[Reg]);
     };
 
     switch(CsOp.type)
@@ -24,7 +24,6 @@
 
 #include "../../AuxDataSchema.h"
 #include "../../Endian.h"
-#include "../../Functors.h"
 
 void DataLoader::operator()(const gtirb::Module& Module, souffle::SouffleProgram& Program)
 {
@@ -38,8 +37,6 @@ void DataLoader::operator()(const gtirb::Module& Module, souffle::SouffleProgram
 
 void DataLoader::load(const gtirb::Module& Module, DataFacts& Facts)
 {
-    FunctorContext.useModule(&Module);
-
     std::optional<gtirb::Addr> Min, Max;
     for(const auto& Section : Module.sections())
     {
@@ -23,6 +23,7 @@
 #include "EdgesLoader.h"
 
 #include "../../AuxDataSchema.h"
+#include "../../CfgUtils.h"
 #include "../Relations.h"
 
 void BlocksLoader(const gtirb::Module& Module, souffle::SouffleProgram& Program)
@@ -112,16 +113,23 @@ void CfgLoader(const gtirb::Module& Module, souffle::SouffleProgram& Program)
         }
     }
 
+    // Only visit the out-edges of the blocks of the module, as the CFG is shared by all
+    // modules in the IR.
     const gtirb::CFG& Cfg = Module.getIR()->getCFG();
-    auto [EdgesBegin, EdgesEnd] = boost::edges(Cfg);
-    for(const auto& Edge : boost::make_iterator_range(EdgesBegin, EdgesEnd))
+    for(const gtirb::CodeBlock& Src : Module.code_blocks())
     {
-        auto Source = boost::source(Edge, Cfg);
-        auto Target = boost::target(Edge, Cfg);
-        if(const gtirb::CodeBlock* Src = gtirb::dyn_cast<gtirb::CodeBlock>(Cfg[Source]))
+        std::optional<gtirb::CFG::vertex_descriptor> Source = getCfgVertex(Cfg, &Src);
+        if(!Source)
         {
-            std::optional<gtirb::Addr> SrcAddr = Src->getAddress();
-            assert(SrcAddr && "Found source block without address.");
+            continue;
+        }
+
+        std::optional<gtirb::Addr> SrcAddr = Src.getAddress();
+        assert(SrcAddr && "Found source block without address.");
+
+        for(const auto& Edge : boost::make_iterator_range(boost::out_edges(*Source, Cfg)))
+        {
+            auto Target = boost::target(Edge, Cfg);
 
             const gtirb::EdgeLabel& Label = Cfg[Edge];
             auto [Conditional, Indirect, Type] = edgeProperties(Label);
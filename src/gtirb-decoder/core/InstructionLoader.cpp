@@ -22,6 +22,34 @@
 //===----------------------------------------------------------------------===//
 #include "InstructionLoader.h"
 
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "../../Parallel.h"
+
+namespace
+{
+    using IndexedOperand = std::pair<uint64_t, relations::Operand>;
+
+    template <typename T>
+    void collectOperands(const operands::Table<T>& OpTable, std::vector<IndexedOperand>& Ops)
+    {
+        for(const auto& [Op, Index] : OpTable.entries())
+        {
+            Ops.emplace_back(Index, Op);
+        }
+    }
+
+    template <typename T>
+    void appendFacts(std::vector<T>& To, std::vector<T>&& From)
+    {
+        To.insert(To.end(), std::make_move_iterator(From.begin()),
+                  std::make_move_iterator(From.end()));
+        From.clear();
+    }
+} // namespace
+
 std::string uppercase(std::string S)
 {
     std::transform(S.begin(), S.end(), S.begin(),
@@ -44,7 +72,7 @@ uint8_t rotated_op_index(uint8_t Index, uint8_t OpCount)
 const std::vector<relations::RegBitFieldOp> OperandFacts::reg_bitfields() const
 {
     std::vector<relations::RegBitFieldOp> RegBitFieldsForSouffle;
-    for(auto It = RegBitFields.begin(); It != RegBitFields.end(); ++It)
+    for(auto It = RegBitFields.entries().begin(); It != RegBitFields.entries().end(); ++It)
     {
         auto Regs = It->first;
         auto Index = It->second;
@@ -58,10 +86,155 @@ const std::vector<relations::RegBitFieldOp> OperandFacts::reg_bitfields() const
     return RegBitFieldsForSouffle;
 }
 
+std::vector<uint64_t> OperandFacts::append(const OperandFacts& Other)
+{
+    std::vector<IndexedOperand> Ops;
+    collectOperands(Other.Imm, Ops);
+    collectOperands(Other.Reg, Ops);
+    collectOperands(Other.RegBitFields, Ops);
+    collectOperands(Other.FPImm, Ops);
+    collectOperands(Other.Indirect, Ops);
+    collectOperands(Other.Special, Ops);
+
+    // Adding the operands in their original order assigns the same indices as adding them
+    // here in the first place would have.
+    std::sort(Ops.begin(), Ops.end(), [](const IndexedOperand& A, const IndexedOperand& B) {
+        return A.first < B.first;
+    });
+
+    std::vector<uint64_t> Indices(Other.Index, 0);
+    for(const auto& [Index, Op] : Ops)
+    {
+        Indices[Index] = add(Op);
+    }
+    return Indices;
+}
+
+void InstructionFacts::append(InstructionFacts&& Other, const std::vector<uint64_t>& OperandIndices)
+{
+    for(relations::Instruction& Instruction : Other.Instructions)
+    {
+        for(uint64_t& OpCode : Instruction.OpCodes)
+        {
+            OpCode = OperandIndices[OpCode];
+        }
+    }
+    appendFacts(Instructions, std::move(Other.Instructions));
+    appendFacts(InvalidInstructions, std::move(Other.InvalidInstructions));
+    appendFacts(ShiftedOps, std::move(Other.ShiftedOps));
+    appendFacts(ShiftedWithRegOps, std::move(Other.ShiftedWithRegOps));
+    appendFacts(InstructionWritebackList, std::move(Other.InstructionWritebackList));
+    appendFacts(InstructionCondCodeList, std::move(Other.InstructionCondCodeList));
+    appendFacts(InstructionOpAccessList, std::move(Other.InstructionOpAccessList));
+    appendFacts(RegisterAccesses, std::move(Other.RegisterAccesses));
+}
+
+void InstructionLoader::split(const gtirb::ByteInterval& ByteInterval,
+                              std::vector<DecodeRange>& Ranges)
+{
+    // Keep range boundaries on multiples of MinInstructionSize, so that the ranges decode the
+    // same offsets as a single pass over the byte interval.
+    uint64_t Size = ByteInterval.getInitializedSize();
+    uint64_t Step =
+        std::max<uint64_t>(DecodeChunkSize / MinInstructionSize, 1) * MinInstructionSize;
+    for(uint64_t Begin = 0; Begin < Size; Begin += Step)
+    {
+        Ranges.push_back(DecodeRange{&ByteInterval, Begin, std::min(Begin + Step, Size)});
+    }
+}
+
+void InstructionLoader::loadRanges(const gtirb::Module& Module,
+                                   const std::vector<DecodeRange>& Ranges, BinaryFacts& Facts)
+{
+    size_t Workers = std::min<size_t>(Threads, Ranges.size());
+    if(Workers <= 1)
+    {
+        for(const DecodeRange& Range : Ranges)
+        {
+            loadRange(Module, Range, Facts);
+        }
+        return;
+    }
+
+    // A Capstone handle cannot be used by several threads at once, so each worker decodes
+    // with its own loader.
+    std::vector<std::unique_ptr<InstructionLoader>> Loaders;
+    for(size_t Worker = 0; Worker < Workers; Worker++)
+    {
+        Loaders.push_back(clone());
+    }
+
+    std::vector<BinaryFacts> RangeFacts(Ranges.size());
+    parallelForWorkers(Ranges.size(), static_cast<unsigned int>(Workers),
+                       [&](size_t Worker, size_t Index) {
+                           Loaders[Worker]->loadRange(Module, Ranges[Index], RangeFacts[Index]);
+                       });
+
+    for(BinaryFacts& Range : RangeFacts)
+    {
+        Facts.append(std::move(Range));
+        Range = BinaryFacts();
+    }
+}
+
+const RegisterNames& RegisterNames::get(csh Handle, cs_arch Arch, unsigned int Count)
+{
+    static std::mutex Mutex;
+    static std::map<cs_arch, RegisterNames> Tables;
+
+    std::lock_guard<std::mutex> Lock(Mutex);
+    auto [It, Inserted] = Tables.try_emplace(Arch);
+    if(Inserted)
+    {
+        std::vector<std::string>& Names = It->second.Names;
+        Names.reserve(Count);
+        Names.push_back("NONE");
+        for(unsigned int Reg = 1; Reg < Count; Reg++)
+        {
+            const char* Name = cs_reg_name(Handle, Reg);
+            Names.push_back(Name ? uppercase(Name) : "");
+        }
+    }
+    return It->second;
+}
+
+/**
+Insert register accesses, encoding each distinct register name as a symbol only once.
+*/
+static void insertRegisterAccesses(souffle::SouffleProgram& Program,
+                                   const std::vector<relations::RegisterAccess>& Accesses)
+{
+    souffle::Relation* Relation = Program.getRelation("register_access");
+    if(!Relation)
+    {
+        return;
+    }
+
+    // Names are views of long-lived tables, so equal pointers mean equal names.
+    std::unordered_map<const char*, souffle::RamDomain> Symbols;
+    auto symbol = [&](std::string_view Name) {
+        auto [It, Inserted] = Symbols.try_emplace(Name.data(), 0);
+        if(Inserted)
+        {
+            It->second = Program.getSymbolTable().encode(std::string(Name));
+        }
+        return It->second;
+    };
+
+    for(const relations::RegisterAccess& Access : Accesses)
+    {
+        souffle::tuple Row(Relation);
+        Row << Access.Addr;
+        Row[1] = symbol(Access.Register);
+        Row[2] = symbol(Access.Mode);
+        Relation->insert(Row);
+    }
+}
+
 /**
 Insert BinaryFacts into the Datalog program.
 */
-void InstructionLoader::insert(const BinaryFacts& Facts, souffle::SouffleProgram& Program)
+static void insertFacts(const BinaryFacts& Facts, souffle::SouffleProgram& Program)
 {
     auto& [Instructions, Operands] = Facts;
     relations::insert(Program, "instruction", Instructions.instructions());
@@ -71,7 +244,7 @@ void InstructionLoader::insert(const BinaryFacts& Facts, souffle::SouffleProgram
     relations::insert(Program, "invalid_op_code", Instructions.invalid());
     relations::insert(Program, "op_shifted", Instructions.shiftedOps());
     relations::insert(Program, "op_shifted_w_reg", Instructions.shiftedWithRegOps());
-    relations::insert(Program, "register_access", Instructions.registerAccesses());
+    insertRegisterAccesses(Program, Instructions.registerAccesses());
     relations::insert(Program, "op_immediate", Operands.imm());
     relations::insert(Program, "op_regdirect", Operands.reg());
     relations::insert(Program, "op_fp_immediate", Operands.fp_imm());
@@ -80,6 +253,128 @@ void InstructionLoader::insert(const BinaryFacts& Facts, souffle::SouffleProgram
     relations::insert(Program, "op_register_bitfield", Operands.reg_bitfields());
 }
 
+void InstructionLoader::insert(const BinaryFacts& Facts, souffle::SouffleProgram& Program)
+{
+    insertFacts(Facts, Program);
+}
+
+void DecodedInstructionLoader::operator()([[maybe_unused]] const gtirb::Module& M,
+                                          souffle::SouffleProgram& P)
+{
+    insertFacts(*Facts, P);
+}
+
+std::map<uint64_t, relations::RegOp> readRegisterOperands(souffle::SouffleProgram& Program)
+{
+    std::map<uint64_t, relations::RegOp> RegOperands;
+    if(souffle::Relation* RegRelation = Program.getRelation("op_regdirect"))
+    {
+        for(souffle::tuple& Tuple : *RegRelation)
+        {
+            souffle::RamUnsigned Index;
+            relations::RegOp Reg;
+            Tuple >> Index >> Reg;
+            RegOperands.emplace(Index, std::move(Reg));
+        }
+    }
+    return RegOperands;
+}
+
+std::optional<BinaryFacts> readInstructionFacts(
+    souffle::SouffleProgram& Program, const std::vector<gtirb::Addr>& Addrs,
+    const std::map<uint64_t, relations::RegOp>& RegOperands)
+{
+    std::unordered_set<uint64_t> Selected;
+    Selected.reserve(Addrs.size());
+    for(gtirb::Addr Addr : Addrs)
+    {
+        Selected.insert(static_cast<uint64_t>(Addr));
+    }
+
+    BinaryFacts Facts;
+    souffle::Relation* InstructionRelation = Program.getRelation("instruction");
+    souffle::Relation* ImmRelation = Program.getRelation("op_immediate");
+    souffle::Relation* IndirectRelation = Program.getRelation("op_indirect");
+    if(!InstructionRelation || !ImmRelation || !IndirectRelation)
+    {
+        return std::nullopt;
+    }
+
+    // Operand indices of the program used by the selected instructions, with the index given
+    // to each operand here.
+    std::unordered_map<uint64_t, uint64_t> OperandIndices;
+    std::vector<relations::Instruction> Instructions;
+    for(souffle::tuple& Tuple : *InstructionRelation)
+    {
+        souffle::RamUnsigned Addr, Size, ImmOffset, DispOffset;
+        Tuple >> Addr;
+        if(Selected.count(Addr) == 0)
+        {
+            continue;
+        }
+
+        relations::Instruction Instruction;
+        Tuple >> Size >> Instruction.Prefix >> Instruction.Name;
+        for(size_t I = 0; I < 4; I++)
+        {
+            souffle::RamUnsigned Op;
+            Tuple >> Op;
+            // Unused operands are 0, and only follow the used ones.
+            if(Op != 0)
+            {
+                Instruction.OpCodes.push_back(Op);
+                OperandIndices.emplace(Op, 0);
+            }
+        }
+        Tuple >> ImmOffset >> DispOffset;
+        Instruction.Addr = gtirb::Addr(Addr);
+        Instruction.Size = Size;
+        Instruction.ImmediateOffset = static_cast<uint8_t>(ImmOffset);
+        Instruction.DisplacementOffset = static_cast<uint8_t>(DispOffset);
+        Instructions.push_back(std::move(Instruction));
+    }
+
+    auto addOperand = [&](souffle::RamUnsigned Index, const relations::Operand& Op) {
+        if(auto It = OperandIndices.find(Index); It != OperandIndices.end())
+        {
+            It->second = Facts.Operands.add(Op);
+        }
+    };
+    for(const auto& [Index, Reg] : RegOperands)
+    {
+        addOperand(Index, Reg);
+    }
+    for(souffle::tuple& Tuple : *ImmRelation)
+    {
+        souffle::RamUnsigned Index, Size;
+        souffle::RamSigned Value;
+        Tuple >> Index >> Value >> Size;
+        addOperand(Index, relations::ImmOp{Value, static_cast<uint8_t>(Size)});
+    }
+    for(souffle::tuple& Tuple : *IndirectRelation)
+    {
+        souffle::RamUnsigned Index, Size;
+        relations::IndirectOp Op;
+        Tuple >> Index >> Op.Reg1 >> Op.Reg2 >> Op.Reg3 >> Op.Mult >> Op.Disp >> Size;
+        Op.Size = static_cast<uint8_t>(Size);
+        addOperand(Index, Op);
+    }
+
+    for(relations::Instruction& Instruction : Instructions)
+    {
+        for(uint64_t& OpCode : Instruction.OpCodes)
+        {
+            OpCode = OperandIndices[OpCode];
+            if(OpCode == 0)
+            {
+                return std::nullopt;
+            }
+        }
+        Facts.Instructions.add(Instruction);
+    }
+    return Facts;
+}
+
 /**
 Load register access facts
 */
@@ -99,13 +394,13 @@ void InstructionLoader::loadRegisterAccesses(BinaryFacts& Facts, uint64_t Addr,
 
     for(uint8_t i = 0; i < RegsReadCount; i++)
     {
-        Facts.Instructions.registerAccess(relations::RegisterAccess{
-            GtirbAddr, "R", uppercase(cs_reg_name(*CsHandle, RegsRead[i]))});
+        Facts.Instructions.registerAccess(
+            relations::RegisterAccess{GtirbAddr, "R", (*Registers)[RegsRead[i]]});
     }
     for(uint8_t i = 0; i < RegsWriteCount; i++)
     {
-        Facts.Instructions.registerAccess(relations::RegisterAccess{
-            GtirbAddr, "W", uppercase(cs_reg_name(*CsHandle, RegsWrite[i]))});
+        Facts.Instructions.registerAccess(
+            relations::RegisterAccess{GtirbAddr, "W", (*Registers)[RegsWrite[i]]});
     }
 
     uint64_t OpCount = operandCount(CsInstruction);
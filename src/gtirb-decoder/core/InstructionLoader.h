@@ -25,11 +25,186 @@
 #include <capstone/capstone.h>
 #include <souffle/SouffleInterface.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <gtirb/gtirb.hpp>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 #include "../Relations.h"
 
+namespace operands
+{
+    inline uint64_t mix(uint64_t H)
+    {
+        H ^= H >> 33;
+        H *= 0xff51afd7ed558ccdULL;
+        H ^= H >> 33;
+        H *= 0xc4ceb9fe1a85ec53ULL;
+        H ^= H >> 33;
+        return H;
+    }
+
+    inline uint64_t combine(uint64_t Seed, uint64_t Value)
+    {
+        return Seed ^ (Value + 0x9e3779b97f4a7c15ULL + (Seed << 6) + (Seed >> 2));
+    }
+
+    inline uint64_t hash(const std::string& S)
+    {
+        return std::hash<std::string>{}(S);
+    }
+
+    inline uint64_t hash(const relations::ImmOp& Op)
+    {
+        return combine(static_cast<uint64_t>(Op.Value), Op.Size);
+    }
+
+    inline uint64_t hash(const std::vector<std::string>& Regs)
+    {
+        uint64_t H = Regs.size();
+        for(const std::string& Reg : Regs)
+        {
+            H = combine(H, hash(Reg));
+        }
+        return H;
+    }
+
+    inline uint64_t hash(const relations::FPImmOp& Op)
+    {
+        // Values that compare equal must hash equally: 0.0 and -0.0, and all NaNs, which the
+        // table treats as a single value.
+        if(Op.Value == 0 || std::isnan(Op.Value))
+        {
+            return std::isnan(Op.Value) ? 1 : 0;
+        }
+        uint64_t Bits;
+        std::memcpy(&Bits, &Op.Value, sizeof(Bits));
+        return Bits;
+    }
+
+    inline uint64_t hash(const relations::IndirectOp& Op)
+    {
+        uint64_t H = hash(Op.Reg1);
+        H = combine(H, hash(Op.Reg2));
+        H = combine(H, hash(Op.Reg3));
+        H = combine(H, static_cast<uint64_t>(Op.Mult));
+        H = combine(H, static_cast<uint64_t>(Op.Disp));
+        return combine(H, Op.Size);
+    }
+
+    inline uint64_t hash(const relations::SpecialOp& Op)
+    {
+        return combine(hash(Op.Type), hash(Op.Value));
+    }
+
+    // Operands are the same if neither orders before the other, as in a std::map.
+    template <typename T>
+    bool equal(const T& A, const T& B)
+    {
+        return !(A < B) && !(B < A);
+    }
+
+    inline bool equal(const std::string& A, const std::string& B)
+    {
+        return A == B;
+    }
+
+    inline bool equal(const std::vector<std::string>& A, const std::vector<std::string>& B)
+    {
+        return A == B;
+    }
+
+    inline bool equal(const relations::FPImmOp& A, const relations::FPImmOp& B)
+    {
+        return A.Value == B.Value || (std::isnan(A.Value) && std::isnan(B.Value));
+    }
+
+    /**
+    Table of the distinct operands of one kind.
+
+    Operands are stored once, in the order they were added, together with their index.
+    They are found through an open-addressing hash table that keeps the hash of each
+    operand, so probes compare operands only when their hashes match, and growing the
+    table never hashes an operand again.
+    */
+    template <typename T>
+    class Table
+    {
+    public:
+        using Entry = std::pair<T, uint64_t>;
+
+        // Return the index of Op, giving it index Next (and incrementing Next) if it is new.
+        uint64_t index(const T& Op, uint64_t& Next)
+        {
+            if((Entries.size() + 1) * 4 > Slots.size() * 3)
+            {
+                grow();
+            }
+
+            uint64_t Hash = mix(hash(Op));
+            size_t Mask = Slots.size() - 1;
+            for(size_t Pos = Hash & Mask;; Pos = (Pos + 1) & Mask)
+            {
+                Slot& S = Slots[Pos];
+                if(S.Entry == 0)
+                {
+                    Entries.emplace_back(Op, Next);
+                    S = Slot{Hash, Entries.size()};
+                    return Next++;
+                }
+                const Entry& E = Entries[S.Entry - 1];
+                if(S.Hash == Hash && equal(E.first, Op))
+                {
+                    return E.second;
+                }
+            }
+        }
+
+        // Operands in the order they were added, i.e., by increasing index.
+        const std::vector<Entry>& entries() const
+        {
+            return Entries;
+        }
+
+    private:
+        struct Slot
+        {
+            uint64_t Hash;
+            // One past the position of the operand in Entries, or 0 for an empty slot.
+            size_t Entry;
+        };
+
+        void grow()
+        {
+            std::vector<Slot> Old(std::max<size_t>(Slots.size() * 2, 16), Slot{0, 0});
+            Old.swap(Slots);
+            size_t Mask = Slots.size() - 1;
+            for(const Slot& S : Old)
+            {
+                if(S.Entry != 0)
+                {
+                    size_t Pos = S.Hash & Mask;
+                    while(Slots[Pos].Entry != 0)
+                    {
+                        Pos = (Pos + 1) & Mask;
+                    }
+                    Slots[Pos] = S;
+                }
+            }
+        }
+
+        std::vector<Entry> Entries;
+        std::vector<Slot> Slots;
+    };
+} // namespace operands
+
 class OperandFacts
 {
 public:
@@ -40,83 +215,77 @@ public:
 
     uint64_t operator()(const relations::ImmOp& Op)
     {
-        return index(Imm, Op);
+        return Imm.index(Op, Index);
     }
 
     uint64_t operator()(const relations::RegOp& Op)
     {
-        return index(Reg, Op);
+        return Reg.index(Op, Index);
     }
 
     uint64_t operator()(const std::vector<std::string>& Op)
     {
-        return index(RegBitFields, Op);
+        return RegBitFields.index(Op, Index);
     }
 
     uint64_t operator()(const relations::FPImmOp& Op)
     {
-        return index(FPImm, Op);
+        return FPImm.index(Op, Index);
     }
 
     uint64_t operator()(const relations::IndirectOp& Op)
     {
-        return index(Indirect, Op);
+        return Indirect.index(Op, Index);
     }
 
     uint64_t operator()(const relations::SpecialOp& Op)
     {
-        return index(Special, Op);
+        return Special.index(Op, Index);
     }
 
-    const std::map<relations::ImmOp, uint64_t>& imm() const
+    const std::vector<std::pair<relations::ImmOp, uint64_t>>& imm() const
     {
-        return Imm;
+        return Imm.entries();
     }
 
-    const std::map<relations::RegOp, uint64_t>& reg() const
+    const std::vector<std::pair<relations::RegOp, uint64_t>>& reg() const
     {
-        return Reg;
+        return Reg.entries();
     }
 
-    const std::map<relations::FPImmOp, uint64_t>& fp_imm() const
+    const std::vector<std::pair<relations::FPImmOp, uint64_t>>& fp_imm() const
     {
-        return FPImm;
+        return FPImm.entries();
     }
 
-    const std::map<relations::IndirectOp, uint64_t>& indirect() const
+    const std::vector<std::pair<relations::IndirectOp, uint64_t>>& indirect() const
     {
-        return Indirect;
+        return Indirect.entries();
     }
 
-    const std::map<relations::SpecialOp, uint64_t>& special() const
+    const std::vector<std::pair<relations::SpecialOp, uint64_t>>& special() const
     {
-        return Special;
+        return Special.entries();
     }
 
     const std::vector<relations::RegBitFieldOp> reg_bitfields() const;
 
-protected:
-    template <typename T>
-    uint64_t index(std::map<T, uint64_t>& OpTable, const T& Op)
-    {
-        auto [Iter, Inserted] = OpTable.try_emplace(Op, Index);
-        if(Inserted)
-        {
-            Index++;
-        }
-        return Iter->second;
-    }
+    /**
+    Add the operands of another table in the order it first saw them, and return the index
+    assigned here to each of its indices.
+    */
+    std::vector<uint64_t> append(const OperandFacts& Other);
 
 private:
     // We reserve 0 for empty operators.
     uint64_t Index = 1;
 
-    std::map<relations::ImmOp, uint64_t> Imm;
-    std::map<relations::RegOp, uint64_t> Reg;
-    std::map<std::vector<std::string>, uint64_t> RegBitFields;
-    std::map<relations::FPImmOp, uint64_t> FPImm;
-    std::map<relations::IndirectOp, uint64_t> Indirect;
-    std::map<relations::SpecialOp, uint64_t> Special;
+    operands::Table<relations::ImmOp> Imm;
+    operands::Table<relations::RegOp> Reg;
+    operands::Table<std::vector<std::string>> RegBitFields;
+    operands::Table<relations::FPImmOp> FPImm;
+    operands::Table<relations::IndirectOp> Indirect;
+    operands::Table<relations::SpecialOp> Special;
 };
 
 class InstructionFacts
@@ -202,6 +371,12 @@ public:
         return RegisterAccesses;
     }
 
+    /**
+    Move the facts of another object to the end of this one, translating the operand indices
+    of its instructions with OperandIndices.
+    */
+    void append(InstructionFacts&& Other, const std::vector<uint64_t>& OperandIndices);
+
 private:
     std::vector<relations::Instruction> Instructions;
     std::vector<gtirb::Addr> InvalidInstructions;
@@ -213,10 +388,64 @@ private:
     std::vector<relations::RegisterAccess> RegisterAccesses;
 };
 
+/**
+Uppercase Capstone register names of an architecture, indexed by register id, with "NONE"
+for the invalid register. Each table is built once and kept for the life of the process, so
+facts can refer to its names without copying them.
+*/
+class RegisterNames
+{
+public:
+    // Get the table for Arch, building it with Handle if needed. Count is one past the
+    // largest register id of the architecture.
+    static const RegisterNames& get(csh Handle, cs_arch Arch, unsigned int Count);
+
+    std::string_view operator[](unsigned int Reg) const
+    {
+        assert(Reg < Names.size() && "Unknown register id.");
+        return Names[Reg];
+    }
+
+private:
+    std::vector<std::string> Names;
+};
+
 struct BinaryFacts
 {
     InstructionFacts Instructions;
     OperandFacts Operands;
+
+    // Append facts decoded separately, numbering their operands as if they had been decoded
+    // after the facts already here.
+    void append(BinaryFacts&& Other)
+    {
+        std::vector<uint64_t> OperandIndices = Operands.append(Other.Operands);
+        Instructions.append(std::move(Other.Instructions), OperandIndices);
+    }
+};
+
+/**
+Read the register operands of a program loaded by an InstructionLoader, by operand index.
+Souffle may purge the op_regdirect input relation while running the program, so they must be
+read before.
+*/
+std::map<uint64_t, relations::RegOp> readRegisterOperands(souffle::SouffleProgram& Program);
+
+/**
+Read the facts of the instructions at the given addresses back from a program loaded by an
+InstructionLoader, with their register operands, read by readRegisterOperands before running
+the program, and their immediate and indirect operands. Returns nothing if one of these
+instructions has an operand of another kind, which the program does not keep.
+*/
+std::optional<BinaryFacts> readInstructionFacts(
+    souffle::SouffleProgram& Program, const std::vector<gtirb::Addr>& Addrs,
+    const std::map<uint64_t, relations::RegOp>& RegOperands);
+
+// Load instruction facts decoded by an earlier pass instead of decoding them again.
+struct DecodedInstructionLoader
+{
+    void operator()(const gtirb::Module& M, souffle::SouffleProgram& P);
+    std::shared_ptr<const BinaryFacts> Facts;
 };
 
 class InstructionLoader
@@ -227,6 +456,7 @@ public:
     void operator()(const gtirb::Module& Module, souffle::SouffleProgram& Program)
     {
         BinaryFacts Facts;
+        Threads = static_cast<unsigned int>(std::max<size_t>(Program.getNumThreads(), 1));
         load(Module, Facts);
         insert(Facts, Program);
     }
@@ -241,10 +471,26 @@ protected:
         });
     };
 
+    // Offsets [Begin, End) of a byte interval at which to decode instructions. Instructions
+    // starting in the range may extend past its end.
+    struct DecodeRange
+    {
+        const gtirb::ByteInterval* ByteInterval;
+        uint64_t Begin;
+        uint64_t End;
+    };
+
+    // Byte interval offsets decoded by a single task when loading in parallel.
+    static constexpr uint64_t DecodeChunkSize = 64 * 1024;
+
+    // Create a loader with the same configuration and its own Capstone handle.
+    virtual std::unique_ptr<InstructionLoader> clone() const = 0;
+
     virtual void insert(const BinaryFacts& Facts, souffle::SouffleProgram& Program);
 
     virtual void load(const gtirb::Module& Module, BinaryFacts& Facts)
     {
+        std::vector<DecodeRange> Ranges;
         for(const auto& Section : Module.sections())
         {
             bool Executable = Section.isFlagSet(gtirb::SectionFlag::Executable);
@@ -252,32 +498,47 @@ protected:
             {
                 for(const auto& ByteInterval : Section.byte_intervals())
                 {
-                    load(Module, ByteInterval, Facts);
+                    split(ByteInterval, Ranges);
                 }
             }
         }
+        loadRanges(Module, Ranges, Facts);
     }
 
     // NOTE: If needed, Module can be used in the inherited functions:
     // e.g., ARM32
-    virtual void load([[maybe_unused]] const gtirb::Module& Module,
-                      const gtirb::ByteInterval& ByteInterval, BinaryFacts& Facts)
+    virtual void load(const gtirb::Module& Module, const gtirb::ByteInterval& ByteInterval,
+                      BinaryFacts& Facts)
+    {
+        loadRange(Module, DecodeRange{&ByteInterval, 0, ByteInterval.getInitializedSize()},
+                  Facts);
+    }
+
+    // Split a byte interval into ranges that can be decoded independently.
+    virtual void split(const gtirb::ByteInterval& ByteInterval, std::vector<DecodeRange>& Ranges);
+
+    // Decode a range of a byte interval.
+    virtual void loadRange([[maybe_unused]] const gtirb::Module& Module, const DecodeRange& Range,
+                           BinaryFacts& Facts)
     {
+        const gtirb::ByteInterval& ByteInterval = *Range.ByteInterval;
         assert(ByteInterval.getAddress() && "ByteInterval is non-addressable.");
 
         uint64_t Addr = static_cast<uint64_t>(*ByteInterval.getAddress());
         uint64_t Size = ByteInterval.getInitializedSize();
         auto Data = ByteInterval.rawBytes<const uint8_t>();
 
-        while(Size > 0)
+        for(uint64_t Offset = Range.Begin; Offset < Range.End; Offset += MinInstructionSize)
         {
-            decode(Facts, Data, Size, Addr);
-            Addr += MinInstructionSize;
-            Data += MinInstructionSize;
-            Size -= MinInstructionSize;
+            decode(Facts, Data + Offset, Size - Offset, Addr + Offset);
         }
     }
 
+    // Decode ranges on up to Threads workers. Facts are merged in range order, so the
+    // result does not depend on the number of threads.
+    void loadRanges(const gtirb::Module& Module, const std::vector<DecodeRange>& Ranges,
+                    BinaryFacts& Facts);
+
     // Load register accesses for a cs_insn
     virtual void loadRegisterAccesses(BinaryFacts& Facts, uint64_t Addr,
                                       const cs_insn& CsInstruction);
@@ -291,6 +552,12 @@ protected:
     // We default to decoding instructions at every byte offset.
     uint8_t MinInstructionSize = 1;
 
+    // Register names of the architecture, set by the architecture's constructor.
+    const RegisterNames* Registers = nullptr;
+
+    // Number of threads used to decode byte intervals.
+    unsigned int Threads = 1;
+
     std::shared_ptr<csh> CsHandle;
 };
 
@@ -299,6 +566,11 @@ template <typename T>
 class CodeBlockLoader : public T
 {
 protected:
+    std::unique_ptr<InstructionLoader> clone() const override
+    {
+        return std::make_unique<CodeBlockLoader<T>>();
+    }
+
     void load(const gtirb::Module& Module, BinaryFacts& Facts) override
     {
         for(auto& Block : Module.code_blocks())
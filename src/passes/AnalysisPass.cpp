@@ -57,6 +57,12 @@ AnalysisPassResult AnalysisPass::transform(gtirb::Context& Context, gtirb::Modul
     return Result;
 }
 
+void AnalysisPass::receiveDecodedInstructions(const AnalysisPass* PreviousPass)
+{
+    DecodedInstructions = PreviousPass ? PreviousPass->DecodedInstructions : nullptr;
+}
+
 void AnalysisPass::clear()
 {
+    DecodedInstructions.reset();
 }
@@ -27,10 +27,13 @@
 #include <chrono>
 #include <gtirb/gtirb.hpp>
 #include <list>
+#include <memory>
 #include <string>
 
 namespace fs = boost::filesystem;
 
+struct BinaryFacts;
+
 struct AnalysisPassResult
 {
     std::list<std::string> Warnings;
@@ -64,6 +67,15 @@ public:
         return false;
     }
 
+    /**
+    Whether analyze() only uses data owned by the pass, so that it can run while
+    other threads modify different modules of the same IR.
+    */
+    virtual bool hasThreadSafeAnalyze(void)
+    {
+        return false;
+    }
+
     /**
     Load data from the GTIRB.
     */
@@ -91,6 +103,21 @@ public:
     */
     virtual void clear();
 
+    /**
+    Facts of the first instruction of each code block of the module, decoded by an earlier
+    pass, or nullptr.
+    */
+    std::shared_ptr<const BinaryFacts> getDecodedInstructions() const
+    {
+        return DecodedInstructions;
+    }
+
+    /**
+    Take the decoded instructions of the previous pass of the pipeline, so they are passed on
+    through passes that do not load or decode anything themselves.
+    */
+    void receiveDecodedInstructions(const AnalysisPass* PreviousPass);
+
 protected:
     virtual void loadImpl(AnalysisPassResult& Result, const gtirb::Context& Context,
                           const gtirb::Module& Module, AnalysisPass* PreviousPass = nullptr) = 0;
@@ -100,6 +127,9 @@ protected:
     std::string DebugDirRoot;
     bool MultiModule = false;
 
+    // Passes that change the code blocks of the module must reset this.
+    std::shared_ptr<const BinaryFacts> DecodedInstructions;
+
     std::string getDebugDir(const gtirb::Module& Module)
     {
         fs::path RootPath(DebugDirRoot);
@@ -27,15 +27,29 @@ namespace fs = boost::filesystem;
 
 #include <gtirb/gtirb.hpp>
 #include <gtirb_pprinter/AuxDataUtils.hpp>
+#include <ostream>
+#include <streambuf>
 
 #include "../AuxDataSchema.h"
+#include "../Parallel.h"
 #include "Interpreter.h"
 
 AnalysisPassResult DatalogAnalysisPass::analyze(const gtirb::Module& Module)
 {
     if(!DebugDirRoot.empty())
     {
-        DatalogIO::writeFacts(getDebugDir(Module) + "/", *Program);
+        // The interpreter reads the facts from CSV files.
+        DatalogIO::RelationFormat FactsFormat = ExecutionMode == DatalogExecutionMode::INTERPRETED
+                                                    ? DatalogIO::RelationFormat::CSV
+                                                    : DebugDirFormat;
+        // The interpreter also needs all of them.
+        DatalogIO::RelationFilter FactsFilter;
+        if(ExecutionMode == DatalogExecutionMode::SYNTHESIZED)
+        {
+            FactsFilter = SelectedRelations;
+        }
+        DatalogIO::writeFacts(getDebugDir(Module) + "/", *Program, FactsFormat, ThreadCount,
+                              FactsFilter, getNameSlug());
     }
 
     if(ExecutionMode == DatalogExecutionMode::SYNTHESIZED)
@@ -47,7 +61,8 @@ AnalysisPassResult DatalogAnalysisPass::analyze(const gtirb::Module& Module)
 
     if(!DebugDirRoot.empty())
     {
-        DatalogIO::writeRelations(getDebugDir(Module) + "/", *Program);
+        DatalogIO::writeRelations(getDebugDir(Module) + "/", *Program, DebugDirFormat,
+                                  ThreadCount, SelectedRelations, getNameSlug());
     }
 
     if(ExecutionMode == DatalogExecutionMode::SYNTHESIZED)
@@ -68,17 +83,16 @@ void DatalogAnalysisPass::analyzeImpl(AnalysisPassResult& Result, const gtirb::M
     if(ExecutionMode == DatalogExecutionMode::INTERPRETED)
     {
         // Disassemble with the interpreter engine.
-        runInterpreter(*Module.getIR(), Module, *Program, InterpreterPath, getDebugDir(Module),
-                       LibDir, ProfilePath, ThreadCount);
+        runInterpreter(Module, *Program, InterpreterPath, getDebugDir(Module), LibDir,
+                       ProfilePath, ThreadCount);
     }
     else
     {
         // Disassemble with the compiled, synthesized program.
         Program->setNumThreads(ThreadCount);
-        bool pruneImdtRels = !WriteSouffleOutputs && DebugDirRoot.empty();
         try
         {
-            Program->runAll("", "", false, pruneImdtRels);
+            Program->runAll("", "", false, canPruneRelations());
         }
         catch(std::exception& e)
         {
@@ -87,16 +101,34 @@ void DatalogAnalysisPass::analyzeImpl(AnalysisPassResult& Result, const gtirb::M
     }
 }
 
+bool DatalogAnalysisPass::canPruneRelations() const
+{
+    const std::string Namespace = getNameSlug();
+    if(WriteSouffleOutputs
+       && !SelectedRelations.select(Program->getInputRelations(), Namespace).empty())
+    {
+        return false;
+    }
+    if((WriteSouffleOutputs || !DebugDirRoot.empty())
+       && !SelectedRelations.select(Program->getInternalRelations(), Namespace).empty())
+    {
+        return false;
+    }
+    return true;
+}
+
 void addRelationsToMap(souffle::SouffleProgram& Program,
                        const std::vector<souffle::Relation*>& Relations,
                        std::map<std::string, std::tuple<std::string, std::string>>& Map,
-                       const std::string& Namespace)
+                       const std::string& Namespace, unsigned int Threads)
 {
-    for(souffle::Relation* Relation : Relations)
-    {
+    // Serialize the relations in parallel, then add them to the map in order.
+    std::vector<std::tuple<std::string, std::string>> Tables(Relations.size());
+    parallelFor(Relations.size(), Threads, [&](size_t Index) {
+        souffle::Relation* Relation = Relations[Index];
         if(Relation->getArity() == 0)
         {
-            continue;
+            return;
         }
 
         std::stringstream Type;
@@ -107,19 +139,99 @@ void addRelationsToMap(souffle::SouffleProgram& Program,
         DatalogIO::writeRelation(Csv, Program, Relation);
 
         // TODO: Compress CSV.
-        Map[Namespace + "." + Relation->getName()] = {Type.str(), Csv.str()};
+        Tables[Index] = {Type.str(), Csv.str()};
+    });
+
+    for(size_t Index = 0; Index < Relations.size(); Index++)
+    {
+        if(Relations[Index]->getArity() != 0)
+        {
+            Map[Namespace + "." + Relations[Index]->getName()] = std::move(Tables[Index]);
+        }
     }
 }
 
+/**
+Stream buffer appending the bytes written to it to a vector, so that binary
+relations are serialized directly into their AuxData entry.
+*/
+class ByteVectorBuf : public std::streambuf
+{
+public:
+    explicit ByteVectorBuf(std::vector<uint8_t>& V) : Bytes(V)
+    {
+    }
+
+protected:
+    int_type overflow(int_type C) override
+    {
+        if(!traits_type::eq_int_type(C, traits_type::eof()))
+        {
+            Bytes.push_back(static_cast<uint8_t>(C));
+        }
+        return traits_type::not_eof(C);
+    }
+
+    std::streamsize xsputn(const char* Data, std::streamsize Size) override
+    {
+        Bytes.insert(Bytes.end(), Data, Data + Size);
+        return Size;
+    }
+
+private:
+    std::vector<uint8_t>& Bytes;
+};
+
+void addBinaryRelationsToMap(souffle::SouffleProgram& Program,
+                             const std::vector<souffle::Relation*>& Relations,
+                             std::map<std::string, std::vector<uint8_t>>& Map,
+                             const std::string& Namespace, bool Compress, unsigned int Threads)
+{
+    std::vector<std::vector<uint8_t>> Tables(Relations.size());
+    parallelFor(Relations.size(), Threads, [&](size_t Index) {
+        ByteVectorBuf Buffer(Tables[Index]);
+        std::ostream Stream(&Buffer);
+        DatalogIO::writeBinaryRelation(Stream, Program, Relations[Index], Compress);
+    });
+
+    for(size_t Index = 0; Index < Relations.size(); Index++)
+    {
+        Map[Namespace + "." + Relations[Index]->getName()] = std::move(Tables[Index]);
+    }
+}
+
+void writeBinaryRelationAuxdata(souffle::SouffleProgram& Program, gtirb::Module& Module,
+                                const std::string& Namespace,
+                                const DatalogIO::RelationFilter& Filter, bool Compress,
+                                unsigned int Threads)
+{
+    auto Facts = aux_data::util::getOrDefault<gtirb::schema::SouffleFactsBinary>(Module);
+    auto Outputs = aux_data::util::getOrDefault<gtirb::schema::SouffleOutputsBinary>(Module);
+
+    addBinaryRelationsToMap(Program, Filter.select(Program.getInputRelations(), Namespace),
+                            Facts, Namespace, Compress, Threads);
+    addBinaryRelationsToMap(Program, Filter.select(Program.getInternalRelations(), Namespace),
+                            Outputs, Namespace, Compress, Threads);
+    addBinaryRelationsToMap(Program, Filter.select(Program.getOutputRelations(), Namespace),
+                            Outputs, Namespace, Compress, Threads);
+
+    Module.addAuxData<gtirb::schema::SouffleFactsBinary>(std::move(Facts));
+    Module.addAuxData<gtirb::schema::SouffleOutputsBinary>(std::move(Outputs));
+}
+
 void writeRelationAuxdata(souffle::SouffleProgram& Program, gtirb::Module& Module,
-                          const std::string& Namespace)
+                          const std::string& Namespace, const DatalogIO::RelationFilter& Filter,
+                          unsigned int Threads)
 {
     auto Facts = aux_data::util::getOrDefault<gtirb::schema::SouffleFacts>(Module);
     auto Outputs = aux_data::util::getOrDefault<gtirb::schema::SouffleOutputs>(Module);
 
-    addRelationsToMap(Program, Program.getInputRelations(), Facts, Namespace);
-    addRelationsToMap(Program, Program.getInternalRelations(), Outputs, Namespace);
-    addRelationsToMap(Program, Program.getOutputRelations(), Outputs, Namespace);
+    addRelationsToMap(Program, Filter.select(Program.getInputRelations(), Namespace), Facts,
+                      Namespace, Threads);
+    addRelationsToMap(Program, Filter.select(Program.getInternalRelations(), Namespace),
+                      Outputs, Namespace, Threads);
+    addRelationsToMap(Program, Filter.select(Program.getOutputRelations(), Namespace), Outputs,
+                      Namespace, Threads);
 
     Module.addAuxData<gtirb::schema::SouffleFacts>(std::move(Facts));
     Module.addAuxData<gtirb::schema::SouffleOutputs>(std::move(Outputs));
@@ -130,11 +242,61 @@ void DatalogAnalysisPass::transformImpl(AnalysisPassResult& Result, gtirb::Conte
 {
     if(WriteSouffleOutputs)
     {
-        writeRelationAuxdata(*Program, Module, getNameSlug());
+        if(SouffleOutputsFormat == DatalogIO::RelationFormat::CSV)
+        {
+            writeRelationAuxdata(*Program, Module, getNameSlug(), SelectedRelations,
+                                 ThreadCount);
+        }
+        else
+        {
+            writeBinaryRelationAuxdata(
+                *Program, Module, getNameSlug(), SelectedRelations,
+                SouffleOutputsFormat == DatalogIO::RelationFormat::COMPRESSED_BINARY, ThreadCount);
+        }
+    }
+}
+
+void DatalogAnalysisPass::saveRelations(const std::vector<std::string>& Names)
+{
+    for(const std::string& Name : Names)
+    {
+        if(const souffle::Relation* Relation = Program->getRelation(Name))
+        {
+            SavedRelations[Name] = DatalogIO::saveRelation(Relation);
+        }
+    }
+}
+
+bool DatalogAnalysisPass::exportRelations(const std::vector<std::string>& Names,
+                                          souffle::SouffleProgram& Target)
+{
+    if(!Program)
+    {
+        return false;
+    }
+
+    std::map<std::string, TupleFilter> Exported = getExportedRelations();
+    for(const std::string& Name : Names)
+    {
+        auto It = SavedRelations.find(Name);
+        souffle::Relation* To = Target.getRelation(Name);
+        if(Exported.count(Name) == 0 || It == SavedRelations.end() || !To
+           || !DatalogIO::compatibleRelations(It->second.Relation, To))
+        {
+            return false;
+        }
+    }
+    for(const std::string& Name : Names)
+    {
+        DatalogIO::copyRelation(*Program, SavedRelations[Name], Target, Target.getRelation(Name),
+                                Exported[Name]);
     }
+    return true;
 }
 
 void DatalogAnalysisPass::clear()
 {
+    SavedRelations.clear();
     Program.reset();
+    AnalysisPass::clear();
 }
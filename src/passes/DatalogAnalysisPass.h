@@ -26,9 +26,12 @@
 #include <boost/filesystem.hpp>
 #include <chrono>
 #include <gtirb/gtirb.hpp>
+#include <functional>
 #include <list>
+#include <map>
 #include <optional>
 #include <string>
+#include <vector>
 
 #include "../gtirb-decoder/DatalogIO.h"
 #include "AnalysisPass.h"
@@ -59,9 +62,27 @@ public:
     {
         ThreadCount = J;
     }
-    void enableSouffleOutputs(bool Enable = true)
+    int getThreadCount() const
+    {
+        return ThreadCount;
+    }
+    void enableSouffleOutputs(bool Enable = true,
+                              DatalogIO::RelationFormat Format = DatalogIO::RelationFormat::CSV)
     {
         WriteSouffleOutputs = Enable;
+        SouffleOutputsFormat = Format;
+    }
+    void setDebugDirFormat(DatalogIO::RelationFormat Format)
+    {
+        DebugDirFormat = Format;
+    }
+    /**
+    Only write the relations selected by Filter to the debug directory and the AuxData of
+    enableSouffleOutputs().
+    */
+    void setRelationFilter(const DatalogIO::RelationFilter& Filter)
+    {
+        SelectedRelations = Filter;
     }
     void readHints(const std::string& Filename);
 
@@ -69,12 +90,38 @@ public:
     {
         return *Program;
     };
+    /**
+    The Souffle program of the current module, or nullptr before it is loaded.
+    */
+    const souffle::SouffleProgram* getLoadedProgram() const
+    {
+        return Program.get();
+    };
+
+    /**
+    Copy relations of the loaded program into the relations of the same name of Target, for a
+    following pass that would otherwise load them from the GTIRB. Only exported relations
+    saved before the run, with the same types in Target, are copied; if any of Names is not,
+    nothing is copied and false is returned. Valid from transform() until clear().
+    */
+    bool exportRelations(const std::vector<std::string>& Names, souffle::SouffleProgram& Target);
 
     virtual bool hasLoad(void) override
     {
         return true;
     }
 
+    /**
+    The synthesized program only reads its own relations. The interpreter saves
+    the module data of the functors, and Souffle profiling uses a global profile database,
+    which programs built with profiling always record into.
+    */
+    virtual bool hasThreadSafeAnalyze(void) override
+    {
+        return ExecutionMode == DatalogExecutionMode::SYNTHESIZED && ProfilePath.empty()
+               && !DatalogIO::hasProfiling();
+    }
+
 protected:
     virtual void analyzeImpl(AnalysisPassResult& Result, const gtirb::Module& Module) override;
     virtual void transformImpl(AnalysisPassResult& Result, gtirb::Context& Context,
@@ -85,6 +132,32 @@ protected:
     */
     virtual std::string getSourceFilename() const = 0;
 
+    using TupleFilter = DatalogIO::TupleFilter;
+
+    /**
+    Relations of the program that hold for the module after transform(), with a filter
+    selecting the tuples that still hold, or no filter if they all do. They must be saved
+    with saveRelations() before the run.
+    */
+    virtual std::map<std::string, TupleFilter> getExportedRelations()
+    {
+        return {};
+    }
+
+    /**
+    Save the tuples of relations of the loaded program, which Souffle may purge during the
+    run once it no longer needs them.
+    */
+    void saveRelations(const std::vector<std::string>& Names);
+
+    /**
+    Whether Souffle may purge the relations of the program once it no longer needs them.
+    Output relations are never purged, and the facts of the debug directory are written
+    before the run, so only the other selected relations that are written after it
+    prevent pruning.
+    */
+    bool canPruneRelations() const;
+
     std::string InterpreterPath;
     std::string LibDir;
     std::string ProfilePath;
@@ -93,6 +166,10 @@ protected:
 
     std::unique_ptr<souffle::SouffleProgram> Program;
     bool WriteSouffleOutputs = false;
+    DatalogIO::RelationFormat SouffleOutputsFormat = DatalogIO::RelationFormat::CSV;
+    DatalogIO::RelationFormat DebugDirFormat = DatalogIO::RelationFormat::CSV;
+    DatalogIO::RelationFilter SelectedRelations;
+    std::map<std::string, DatalogIO::SavedRelation> SavedRelations;
 };
 
 #endif /* _DATALOG_ANALYSIS_PASS_H_ */
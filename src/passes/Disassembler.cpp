@@ -27,6 +27,7 @@
 #include <regex>
 
 #include "../AuxDataSchema.h"
+#include "../Parallel.h"
 #include "../gtirb-decoder/Relations.h"
 
 using ImmOp = int64_t;
@@ -575,58 +576,107 @@ void expandSymbolForwarding(gtirb::Module &Module, souffle::SouffleProgram &Prog
     }
 }
 
-template <class ExprType, typename... Args>
-void addSymbolicExpressionToCodeBlock(gtirb::Module &Module, gtirb::Addr Addr, uint64_t Size,
-                                      Args... A)
+// Number of work list entries handled at a time by the parallel read-only phases below.
+constexpr size_t WorkChunkSize = 4096;
+
+size_t chunkCount(size_t Count)
 {
-    if(auto it = Module.findCodeBlocksOn(Addr); !it.empty())
-    {
-        gtirb::CodeBlock &Block = *it.begin();
-        gtirb::ByteInterval *ByteInterval = Block.getByteInterval();
-        std::optional<gtirb::Addr> BaseAddr = ByteInterval->getAddress();
-        assert(BaseAddr && "Found byte interval without address.");
-        // In ARM we substract one for symexprs in thumb mode.
-        if(Module.getISA() == gtirb::ISA::ARM)
-        {
-            Addr -= static_cast<uint64_t>(Addr) & 1;
-        }
-        uint64_t BlockOffset = static_cast<uint64_t>(Addr - *BaseAddr);
-        ByteInterval->addSymbolicExpression<ExprType>(BlockOffset, A...);
-        if(auto *Sizes = Module.getAuxData<gtirb::schema::SymbolicExpressionSizes>())
-        {
-            gtirb::Offset ExpressionOffset = gtirb::Offset(ByteInterval->getUUID(), BlockOffset);
-            (*Sizes)[ExpressionOffset] = Size;
-        }
-    }
+    return (Count + WorkChunkSize - 1) / WorkChunkSize;
 }
 
-void buildSymbolicExpr(gtirb::Module &Module, const gtirb::Addr &Ea,
-                       const SymbolicInfo &SymbolicInfo)
+// Call F(Chunk, Begin, End) for the chunkCount(Count) consecutive chunks of at most
+// WorkChunkSize indices covering [0, Count), on at most Threads worker threads.
+template <typename Function>
+void parallelForChunks(size_t Count, unsigned int Threads, Function &&F)
 {
-    gtirb::SymAttributeSet Attrs =
-        buildSymbolicExpressionAttributes(Ea, SymbolicInfo.SymbolicExprAttributes);
+    parallelFor(chunkCount(Count), Threads, [&](size_t Chunk) {
+        size_t Begin = Chunk * WorkChunkSize;
+        F(Chunk, Begin, std::min(Begin + WorkChunkSize, Count));
+    });
+}
+
+// A symbolic expression of an instruction, located in the byte interval of its code block.
+// Exactly one of SymAddr and SymAddrAddr is set.
+struct CodeSymbolicExpr
+{
+    gtirb::ByteInterval *ByteInterval{nullptr};
+    uint64_t Offset{0};
+    const SymbolicExpr *SymAddr{nullptr};
+    const SymExprSymbolMinusSymbol *SymAddrAddr{nullptr};
+    gtirb::SymAttributeSet Attributes;
+};
+
+// Find the symbolic expression at Ea, if any, without modifying the module.
+std::optional<CodeSymbolicExpr> findCodeSymbolicExpr(gtirb::Module &Module, gtirb::Addr Ea,
+                                                     const SymbolicInfo &SymbolicInfo)
+{
+    CodeSymbolicExpr Expr;
     // SymAddr case
     if(const auto SymExpr = SymbolicInfo.SymbolicExprs.find(Ea);
        SymExpr != SymbolicInfo.SymbolicExprs.end())
     {
-        gtirb::Symbol *FoundSymbol = findFirstSymbol(Module, SymExpr->Symbol);
-        // FIXME: We need to handle overlapping sections here.
-        addSymbolicExpressionToCodeBlock<gtirb::SymAddrConst>(Module, Ea, SymExpr->Size,
-                                                              SymExpr->Addend, FoundSymbol, Attrs);
-        // Symbol-Symbol case
+        Expr.SymAddr = &*SymExpr;
     }
+    // Symbol-Symbol case
     else if(const auto SymExpr = SymbolicInfo.SymbolMinusSymbolSymbolicExprs.find(Ea);
             SymExpr != SymbolicInfo.SymbolMinusSymbolSymbolicExprs.end())
     {
-        gtirb::Symbol *FoundSymbol1 = findFirstSymbol(Module, SymExpr->Symbol1);
-        gtirb::Symbol *FoundSymbol2 = findFirstSymbol(Module, SymExpr->Symbol2);
-        addSymbolicExpressionToCodeBlock<gtirb::SymAddrAddr>(
-            Module, Ea, SymExpr->Size, static_cast<int64_t>(SymExpr->Scale), SymExpr->Offset,
-            FoundSymbol2, FoundSymbol1, Attrs);
+        Expr.SymAddrAddr = &*SymExpr;
+    }
+    else
+    {
+        return std::nullopt;
+    }
+
+    // FIXME: We need to handle overlapping sections here.
+    auto It = Module.findCodeBlocksOn(Ea);
+    if(It.empty())
+    {
+        return std::nullopt;
     }
+    gtirb::CodeBlock &Block = *It.begin();
+    Expr.ByteInterval = Block.getByteInterval();
+    std::optional<gtirb::Addr> BaseAddr = Expr.ByteInterval->getAddress();
+    assert(BaseAddr && "Found byte interval without address.");
+    gtirb::Addr Addr = Ea;
+    // In ARM we substract one for symexprs in thumb mode.
+    if(Module.getISA() == gtirb::ISA::ARM)
+    {
+        Addr -= static_cast<uint64_t>(Addr) & 1;
+    }
+    Expr.Offset = static_cast<uint64_t>(Addr - *BaseAddr);
+    Expr.Attributes = buildSymbolicExpressionAttributes(Ea, SymbolicInfo.SymbolicExprAttributes);
+    return Expr;
 }
 
-void buildCodeSymbolicInformation(gtirb::Module &Module, souffle::SouffleProgram &Program)
+void addCodeSymbolicExpr(gtirb::Module &Module, const CodeSymbolicExpr &Expr)
+{
+    uint64_t Size;
+    if(Expr.SymAddr)
+    {
+        gtirb::Symbol *FoundSymbol = findFirstSymbol(Module, Expr.SymAddr->Symbol);
+        Expr.ByteInterval->addSymbolicExpression<gtirb::SymAddrConst>(
+            Expr.Offset, Expr.SymAddr->Addend, FoundSymbol, Expr.Attributes);
+        Size = Expr.SymAddr->Size;
+    }
+    else
+    {
+        gtirb::Symbol *FoundSymbol1 = findFirstSymbol(Module, Expr.SymAddrAddr->Symbol1);
+        gtirb::Symbol *FoundSymbol2 = findFirstSymbol(Module, Expr.SymAddrAddr->Symbol2);
+        Expr.ByteInterval->addSymbolicExpression<gtirb::SymAddrAddr>(
+            Expr.Offset, static_cast<int64_t>(Expr.SymAddrAddr->Scale),
+            Expr.SymAddrAddr->Offset, FoundSymbol2, FoundSymbol1, Expr.Attributes);
+        Size = Expr.SymAddrAddr->Size;
+    }
+    if(auto *Sizes = Module.getAuxData<gtirb::schema::SymbolicExpressionSizes>())
+    {
+        gtirb::Offset ExpressionOffset = gtirb::Offset(Expr.ByteInterval->getUUID(), Expr.Offset);
+        (*Sizes)[ExpressionOffset] = Size;
+    }
+}
+
+void buildCodeSymbolicInformation(gtirb::Module &Module, souffle::SouffleProgram &Program,
+                                  unsigned int Threads)
 {
     std::set<gtirb::Addr> Code;
     for(auto &output : *Program.getRelation("code_in_refined_block"))
@@ -645,53 +695,111 @@ void buildCodeSymbolicInformation(gtirb::Module &Module, souffle::SouffleProgram
     std::map<gtirb::Addr, DecodedInstruction> decodedInstructions =
         recoverInstructions(Program, Code);
 
+    // Locate the symbolic expressions of each chunk of instructions in parallel, then add them
+    // to the module in address order.
+    std::vector<const std::pair<const gtirb::Addr, DecodedInstruction> *> Instructions;
+    Instructions.reserve(Code.size());
     for(auto &EA : Code)
     {
         const auto Inst = decodedInstructions.find(EA);
         assert(Inst != decodedInstructions.end());
-        for(auto &Op : Inst->second.Operands)
+        Instructions.push_back(&*Inst);
+    }
+    std::vector<std::vector<CodeSymbolicExpr>> Exprs(chunkCount(Instructions.size()));
+    parallelForChunks(Instructions.size(), Threads, [&](size_t Chunk, size_t Begin, size_t End) {
+        std::vector<CodeSymbolicExpr> &ChunkExprs = Exprs[Chunk];
+        for(size_t Index = Begin; Index < End; Index++)
         {
-            if(std::get_if<ImmOp>(&Op.second))
-                buildSymbolicExpr(Module, gtirb::Addr(Inst->first + Inst->second.immediateOffset),
-                                  symbolicInfo);
-            if(std::get_if<IndirectOp>(&Op.second))
-                buildSymbolicExpr(Module,
-                                  gtirb::Addr(Inst->first + Inst->second.displacementOffset),
-                                  symbolicInfo);
+            const auto &[EA, Inst] = *Instructions[Index];
+            for(auto &Op : Inst.Operands)
+            {
+                std::optional<CodeSymbolicExpr> Expr;
+                if(std::get_if<ImmOp>(&Op.second))
+                    Expr = findCodeSymbolicExpr(Module, gtirb::Addr(EA + Inst.immediateOffset),
+                                                symbolicInfo);
+                if(std::get_if<IndirectOp>(&Op.second))
+                    Expr = findCodeSymbolicExpr(
+                        Module, gtirb::Addr(EA + Inst.displacementOffset), symbolicInfo);
+                if(Expr)
+                    ChunkExprs.push_back(std::move(*Expr));
+            }
+        }
+    });
+
+    for(const std::vector<CodeSymbolicExpr> &ChunkExprs : Exprs)
+    {
+        for(const CodeSymbolicExpr &Expr : ChunkExprs)
+        {
+            addCodeSymbolicExpr(Module, Expr);
         }
     }
 }
 
+// A code block located in its byte interval.
+struct CodeBlockPlacement
+{
+    gtirb::ByteInterval *ByteInterval;
+    uint64_t Offset;
+    uint64_t Size;
+    gtirb::DecodeMode DecodeMode;
+};
+
+std::optional<CodeBlockPlacement> placeCodeBlock(gtirb::Module &Module,
+                                                 const VectorByEA<BlockInformation> &BlockInfo,
+                                                 gtirb::Addr BlockAddress)
+{
+    if(auto Sections = Module.findSectionsOn(BlockAddress); !Sections.empty())
+    {
+        gtirb::Section &Section = *Sections.begin();
+        uint64_t BlockSize = BlockInfo.find(BlockAddress)->size;
+        if(auto It = Section.findByteIntervalsOn(BlockAddress); !It.empty())
+        {
+            if(gtirb::ByteInterval &ByteInterval = *It.begin(); ByteInterval.getAddress())
+            {
+                uint64_t BlockOffset = BlockAddress - *ByteInterval.getAddress();
+                gtirb::DecodeMode DecodeMode = gtirb::DecodeMode::Default;
+                if((static_cast<uint64_t>(BlockAddress) & 1)
+                   && (Module.getISA() == gtirb::ISA::ARM))
+                {
+                    DecodeMode = gtirb::DecodeMode::Thumb;
+                }
+                return CodeBlockPlacement{&ByteInterval, BlockOffset, BlockSize, DecodeMode};
+            }
+        }
+    }
+    return std::nullopt;
+}
+
 void buildCodeBlocks(gtirb::Context &Context, gtirb::Module &Module,
-                     souffle::SouffleProgram &Program)
+                     souffle::SouffleProgram &Program, unsigned int Threads)
 {
     auto BlockInfo =
         convertSortedRelation<VectorByEA<BlockInformation>>("block_information", Program);
 
+    std::vector<gtirb::Addr> BlockAddresses;
     for(auto &Tuple : *Program.getRelation("refined_block"))
     {
         gtirb::Addr BlockAddress;
         Tuple >> BlockAddress;
+        BlockAddresses.push_back(BlockAddress);
+    }
 
-        if(auto Sections = Module.findSectionsOn(BlockAddress); !Sections.empty())
+    // Locate the blocks in parallel, then add them to their byte intervals.
+    std::vector<std::optional<CodeBlockPlacement>> Placements(BlockAddresses.size());
+    parallelForChunks(BlockAddresses.size(), Threads, [&](size_t, size_t Begin, size_t End) {
+        for(size_t Index = Begin; Index < End; Index++)
         {
-            gtirb::Section &Section = *Sections.begin();
-            uint64_t BlockSize = BlockInfo.find(BlockAddress)->size;
-            if(auto It = Section.findByteIntervalsOn(BlockAddress); !It.empty())
-            {
-                if(gtirb::ByteInterval &ByteInterval = *It.begin(); ByteInterval.getAddress())
-                {
-                    uint64_t BlockOffset = BlockAddress - *ByteInterval.getAddress();
-                    gtirb::DecodeMode DecodeMode = gtirb::DecodeMode::Default;
-                    if((static_cast<uint64_t>(BlockAddress) & 1)
-                       && (Module.getISA() == gtirb::ISA::ARM))
-                    {
-                        DecodeMode = gtirb::DecodeMode::Thumb;
-                    }
-                    ByteInterval.addBlock<gtirb::CodeBlock>(Context, BlockOffset, BlockSize,
-                                                            DecodeMode);
-                }
-            }
+            Placements[Index] = placeCodeBlock(Module, BlockInfo, BlockAddresses[Index]);
+        }
+    });
+
+    for(const std::optional<CodeBlockPlacement> &Placement : Placements)
+    {
+        if(Placement)
+        {
+            Placement->ByteInterval->addBlock<gtirb::CodeBlock>(Context, Placement->Offset,
+                                                                Placement->Size,
+                                                                Placement->DecodeMode);
         }
     }
 }
@@ -730,8 +838,29 @@ void buildBSS(gtirb::Context &context, gtirb::Module &module, souffle::SoufflePr
     }
 }
 
+// A data block of an initialized data segment, located in its byte interval. At most one of
+// SymAddr and SymAddrAddr is set, and Type is the encoding of the block, if it has one.
+struct DataBlockPlacement
+{
+    gtirb::ByteInterval *ByteInterval{nullptr};
+    uint64_t Offset{0};
+    uint64_t Size{0};
+    const SymbolicExpr *SymAddr{nullptr};
+    const SymExprSymbolMinusSymbol *SymAddrAddr{nullptr};
+    gtirb::SymAttributeSet Attributes;
+    const std::string *Type{nullptr};
+};
+
+// The data blocks of an initialized data segment in address order. MissingAddress is set if
+// the segment reaches an address that is not in any byte interval.
+struct DataSegmentBlocks
+{
+    std::vector<DataBlockPlacement> Blocks;
+    std::optional<gtirb::Addr> MissingAddress;
+};
+
 void buildDataBlocks(gtirb::Context &Context, gtirb::Module &Module,
-                     souffle::SouffleProgram &Program)
+                     souffle::SouffleProgram &Program, unsigned int Threads)
 {
     auto SymbolicExprs = convertSortedRelation<VectorByEA<SymbolicExpr>>("symbolic_expr", Program);
     auto SymbolMinusSymbol = convertSortedRelation<VectorByEA<SymExprSymbolMinusSymbol>>(
@@ -745,83 +874,120 @@ void buildDataBlocks(gtirb::Context &Context, gtirb::Module &Module,
     auto SymbolicExprAttributes = convertSortedRelation<VectorByEA<SymbolicExprAttribute>>(
         "symbolic_expr_attribute", Program);
 
-    std::map<gtirb::UUID, std::string> TypesTable;
-
-    std::map<gtirb::Offset, uint64_t> SymbolicSizes;
-
+    std::vector<std::pair<gtirb::Addr, gtirb::Addr>> Segments;
     for(auto &Output : *Program.getRelation("initialized_data_segment"))
     {
         gtirb::Addr Begin, End;
         Output >> Begin >> End;
+        Segments.emplace_back(Begin, End);
         // we don't create data blocks that exceed the data segment
         DataBoundary.insert(End);
+    }
+    // do not cross byte intervals.
+    for(const gtirb::ByteInterval &ByteInterval : Module.byte_intervals())
+    {
+        if(std::optional<gtirb::Addr> Addr = ByteInterval.getAddress())
+        {
+            DataBoundary.insert(*Addr + ByteInterval.getSize());
+        }
+    }
+
+    // Split the segments into data blocks in parallel. The boundaries are complete at this
+    // point, so each segment is independent of the others.
+    std::vector<DataSegmentBlocks> SegmentBlocks(Segments.size());
+    parallelFor(Segments.size(), Threads, [&](size_t Index) {
+        auto [Begin, End] = Segments[Index];
         for(auto CurrentAddr = Begin; CurrentAddr < End;
             /*incremented in each case*/)
         {
-            gtirb::DataBlock *DataBlock = nullptr;
-            if(auto It = Module.findByteIntervalsOn(CurrentAddr); !It.empty())
+            auto It = Module.findByteIntervalsOn(CurrentAddr);
+            if(It.empty())
             {
-                if(gtirb::ByteInterval &ByteInterval = *It.begin(); ByteInterval.getAddress())
+                SegmentBlocks[Index].MissingAddress = CurrentAddr;
+                return;
+            }
+            if(gtirb::ByteInterval &ByteInterval = *It.begin(); ByteInterval.getAddress())
+            {
+                DataBlockPlacement Block;
+                Block.ByteInterval = &ByteInterval;
+                Block.Offset = CurrentAddr - *ByteInterval.getAddress();
+
+                // symbolic expression created from relocation
+                if(const auto SymExpr = SymbolicExprs.find(CurrentAddr);
+                   SymExpr != SymbolicExprs.end())
                 {
-                    // do not cross byte intervals.
-                    DataBoundary.insert(*ByteInterval.getAddress() + ByteInterval.getSize());
-                    uint64_t blockOffset = CurrentAddr - *ByteInterval.getAddress();
-                    gtirb::Offset Offset = gtirb::Offset(ByteInterval.getUUID(), blockOffset);
-
-                    // symbolic expression created from relocation
-                    if(const auto SymExpr = SymbolicExprs.find(CurrentAddr);
-                       SymExpr != SymbolicExprs.end())
-                    {
-                        DataBlock = gtirb::DataBlock::Create(Context, SymExpr->Size);
-                        gtirb::Symbol *foundSymbol = findFirstSymbol(Module, SymExpr->Symbol);
-                        gtirb::SymAttributeSet Attributes =
-                            buildSymbolicExpressionAttributes(CurrentAddr, SymbolicExprAttributes);
-
-                        ByteInterval.addSymbolicExpression<gtirb::SymAddrConst>(
-                            blockOffset, SymExpr->Addend, foundSymbol, Attributes);
-                        SymbolicSizes[Offset] = SymExpr->Size;
-                    }
-                    else if(const auto SymExprSymMinusSym = SymbolMinusSymbol.find(CurrentAddr);
-                            SymExprSymMinusSym != SymbolMinusSymbol.end())
-                    {
-                        DataBlock = gtirb::DataBlock::Create(Context, SymExprSymMinusSym->Size);
-                        gtirb::Symbol *Sym1 = findFirstSymbol(Module, SymExprSymMinusSym->Symbol1);
-                        gtirb::Symbol *Sym2 = findFirstSymbol(Module, SymExprSymMinusSym->Symbol2);
-                        gtirb::SymAttributeSet Attributes =
-                            buildSymbolicExpressionAttributes(CurrentAddr, SymbolicExprAttributes);
-
-                        ByteInterval.addSymbolicExpression<gtirb::SymAddrAddr>(
-                            blockOffset, static_cast<int64_t>(SymExprSymMinusSym->Scale),
-                            SymExprSymMinusSym->Offset, Sym2, Sym1, Attributes);
-                        SymbolicSizes[Offset] = SymExprSymMinusSym->Size;
-                    }
-                    else
-                        // string
-                        if(const auto S = DataStrings.find(CurrentAddr); S != DataStrings.end())
-                    {
-                        DataBlock = gtirb::DataBlock::Create(Context, S->End - CurrentAddr);
-                        TypesTable[DataBlock->getUUID()] = S->Encoding;
-                    }
-                    else
-                    {
-                        // Accumulate region with no symbols into a single DataBlock.
-                        auto NextDataObject = DataBoundary.lower_bound(CurrentAddr + 1);
-                        DataBlock =
-                            gtirb::DataBlock::Create(Context, *NextDataObject - CurrentAddr);
-                    }
-                    // symbol special types
-                    const auto specialType = SymbolSpecialTypes.find(CurrentAddr);
-                    if(specialType != SymbolSpecialTypes.end())
-                        TypesTable[DataBlock->getUUID()] = specialType->Type;
-                    ByteInterval.addBlock(blockOffset, DataBlock);
-                    CurrentAddr += DataBlock->getSize();
+                    Block.Size = SymExpr->Size;
+                    Block.SymAddr = &*SymExpr;
+                    Block.Attributes =
+                        buildSymbolicExpressionAttributes(CurrentAddr, SymbolicExprAttributes);
+                }
+                else if(const auto SymExprSymMinusSym = SymbolMinusSymbol.find(CurrentAddr);
+                        SymExprSymMinusSym != SymbolMinusSymbol.end())
+                {
+                    Block.Size = SymExprSymMinusSym->Size;
+                    Block.SymAddrAddr = &*SymExprSymMinusSym;
+                    Block.Attributes =
+                        buildSymbolicExpressionAttributes(CurrentAddr, SymbolicExprAttributes);
+                }
+                else
+                    // string
+                    if(const auto S = DataStrings.find(CurrentAddr); S != DataStrings.end())
+                {
+                    Block.Size = S->End - CurrentAddr;
+                    Block.Type = &S->Encoding;
+                }
+                else
+                {
+                    // Accumulate region with no symbols into a single DataBlock.
+                    auto NextDataObject = DataBoundary.lower_bound(CurrentAddr + 1);
+                    Block.Size = *NextDataObject - CurrentAddr;
                 }
+                // symbol special types
+                const auto specialType = SymbolSpecialTypes.find(CurrentAddr);
+                if(specialType != SymbolSpecialTypes.end())
+                    Block.Type = &specialType->Type;
+                CurrentAddr += Block.Size;
+                SegmentBlocks[Index].Blocks.push_back(std::move(Block));
             }
-            else
+        }
+    });
+
+    std::map<gtirb::UUID, std::string> TypesTable;
+
+    std::map<gtirb::Offset, uint64_t> SymbolicSizes;
+
+    for(const DataSegmentBlocks &Segment : SegmentBlocks)
+    {
+        for(const DataBlockPlacement &Block : Segment.Blocks)
+        {
+            gtirb::ByteInterval &ByteInterval = *Block.ByteInterval;
+            gtirb::Offset Offset = gtirb::Offset(ByteInterval.getUUID(), Block.Offset);
+            gtirb::DataBlock *DataBlock = gtirb::DataBlock::Create(Context, Block.Size);
+            if(Block.SymAddr)
+            {
+                gtirb::Symbol *foundSymbol = findFirstSymbol(Module, Block.SymAddr->Symbol);
+                ByteInterval.addSymbolicExpression<gtirb::SymAddrConst>(
+                    Block.Offset, Block.SymAddr->Addend, foundSymbol, Block.Attributes);
+                SymbolicSizes[Offset] = Block.Size;
+            }
+            else if(Block.SymAddrAddr)
             {
-                std::cerr << "ByteInterval at address " << CurrentAddr << " not found" << std::endl;
-                exit(1);
+                gtirb::Symbol *Sym1 = findFirstSymbol(Module, Block.SymAddrAddr->Symbol1);
+                gtirb::Symbol *Sym2 = findFirstSymbol(Module, Block.SymAddrAddr->Symbol2);
+                ByteInterval.addSymbolicExpression<gtirb::SymAddrAddr>(
+                    Block.Offset, static_cast<int64_t>(Block.SymAddrAddr->Scale),
+                    Block.SymAddrAddr->Offset, Sym2, Sym1, Block.Attributes);
+                SymbolicSizes[Offset] = Block.Size;
             }
+            if(Block.Type)
+                TypesTable[DataBlock->getUUID()] = *Block.Type;
+            ByteInterval.addBlock(Block.Offset, DataBlock);
+        }
+        if(Segment.MissingAddress)
+        {
+            std::cerr << "ByteInterval at address " << *Segment.MissingAddress << " not found"
+                      << std::endl;
+            exit(1);
         }
     }
     buildBSS(Context, Module, Program);
@@ -1623,17 +1789,17 @@ void removePreviousModuleContent(gtirb::Module &Module)
     }
 }
 void disassembleModule(gtirb::Context &Context, gtirb::Module &Module,
-                       souffle::SouffleProgram &Program, bool SelfDiagnose)
+                       souffle::SouffleProgram &Program, bool SelfDiagnose, unsigned int Threads)
 {
     removeSectionSymbols(Context, Module);
     removeEntryPoint(Module);
     removePreviousModuleContent(Module);
     buildInferredSymbols(Context, Module, Program);
     buildSymbolForwarding(Context, Module, Program);
-    buildCodeBlocks(Context, Module, Program);
-    buildDataBlocks(Context, Module, Program);
+    buildCodeBlocks(Context, Module, Program, Threads);
+    buildDataBlocks(Context, Module, Program, Threads);
     buildAlignments(Module, Program);
-    buildCodeSymbolicInformation(Module, Program);
+    buildCodeSymbolicInformation(Module, Program, Threads);
     buildCfiDirectives(Module, Program);
     buildSehTable(Module, Program);
     expandSymbolForwarding(Module, Program);
@@ -28,8 +28,10 @@
 
 #include "AnalysisPass.h"
 
+// Build the module contents from the results of the disassembly analysis. The read-only parts
+// of building code blocks, data blocks and symbolic expressions use up to Threads threads.
 void disassembleModule(gtirb::Context &context, gtirb::Module &module,
-                       souffle::SouffleProgram &Program, bool selfDiagnose);
+                       souffle::SouffleProgram &Program, bool selfDiagnose, unsigned int Threads);
 void performSanityChecks(AnalysisPassResult &Result, souffle::SouffleProgram &Program,
                          bool selfDiagnose, bool ignoreErrors);
 
@@ -24,6 +24,7 @@
 
 #include "../gtirb-decoder/CompositeLoader.h"
 #include "../gtirb-decoder/Relations.h"
+#include "../gtirb-decoder/core/InstructionLoader.h"
 #include "../gtirb-decoder/core/ModuleLoader.h"
 #include "Disassembler.h"
 
@@ -41,7 +42,9 @@ void DisassemblyPass::loadImpl(AnalysisPassResult& Result, const gtirb::Context&
     if(auto It = Factories.find(Target); It != Factories.end())
     {
         auto Loader = (It->second)();
-        Program = Loader.load(Module);
+        Program = Loader.load(Module, ThreadCount);
+        FunctorData =
+            std::make_unique<FunctorContextRegistration>(Program->getSymbolTable(), Module);
     }
     else
     {
@@ -68,11 +71,48 @@ void DisassemblyPass::loadImpl(AnalysisPassResult& Result, const gtirb::Context&
     }
 }
 
+void DisassemblyPass::analyzeImpl(AnalysisPassResult& Result, const gtirb::Module& Module)
+{
+    if(KeepDecodedInstructions && Module.getISA() == gtirb::ISA::X64)
+    {
+        RegOperands = readRegisterOperands(*Program);
+    }
+    DatalogAnalysisPass::analyzeImpl(Result, Module);
+}
+
 void DisassemblyPass::transformImpl(AnalysisPassResult& Result, gtirb::Context& Context,
                                     gtirb::Module& Module)
 {
     DatalogAnalysisPass::transformImpl(Result, Context, Module);
 
-    disassembleModule(Context, Module, *Program, SelfDiagnose);
+    disassembleModule(Context, Module, *Program, SelfDiagnose,
+                      static_cast<unsigned int>(ThreadCount));
     performSanityChecks(Result, *Program, SelfDiagnose, IgnoreErrors);
+
+    // Keep the decoded instructions at the start of the code blocks for function inference,
+    // which would otherwise decode them again.
+    if(!KeepDecodedInstructions || Module.getISA() != gtirb::ISA::X64)
+    {
+        return;
+    }
+    std::vector<gtirb::Addr> BlockAddrs;
+    for(const auto& Block : Module.code_blocks())
+    {
+        if(std::optional<gtirb::Addr> Addr = Block.getAddress())
+        {
+            BlockAddrs.push_back(*Addr);
+        }
+    }
+    if(std::optional<BinaryFacts> Facts = readInstructionFacts(*Program, BlockAddrs, RegOperands))
+    {
+        DecodedInstructions = std::make_shared<const BinaryFacts>(std::move(*Facts));
+    }
+    RegOperands.clear();
+}
+
+void DisassemblyPass::clear()
+{
+    FunctorData.reset();
+    RegOperands.clear();
+    DatalogAnalysisPass::clear();
 }
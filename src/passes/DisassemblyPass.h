@@ -22,15 +22,24 @@
 //===----------------------------------------------------------------------===//
 #ifndef DISASSEMBLY_PASS_H_
 #define DISASSEMBLY_PASS_H_
+#include "../Functors.h"
 #include "../gtirb-decoder/CompositeLoader.h"
+#include "../gtirb-decoder/Relations.h"
 #include "DatalogAnalysisPass.h"
 
 class DisassemblyPass : public DatalogAnalysisPass
 {
 public:
+    /**
+    KeepDecodedInstructions: keep the facts of the first instruction of each code block for
+    the function inference pass, which only uses them on X64.
+    */
     DisassemblyPass(bool SelfDiagnose = false, bool IgnoreErrors = false,
-                    bool NoCfiDirectives = false)
-        : SelfDiagnose(SelfDiagnose), IgnoreErrors(IgnoreErrors), NoCfiDirectives(NoCfiDirectives)
+                    bool NoCfiDirectives = false, bool KeepDecodedInstructions = false)
+        : SelfDiagnose(SelfDiagnose),
+          IgnoreErrors(IgnoreErrors),
+          NoCfiDirectives(NoCfiDirectives),
+          KeepDecodedInstructions(KeepDecodedInstructions)
     {
     }
 
@@ -44,6 +53,8 @@ public:
         return true;
     }
 
+    virtual void clear() override;
+
     // Loader factory registration.
     using Target = std::tuple<gtirb::FileFormat, gtirb::ISA, gtirb::ByteOrder>;
     using Factory = std::function<CompositeLoader()>;
@@ -61,6 +72,7 @@ protected:
 
     void loadImpl(AnalysisPassResult& Result, const gtirb::Context& Context,
                   const gtirb::Module& Module, AnalysisPass* PreviousPass = nullptr) override;
+    void analyzeImpl(AnalysisPassResult& Result, const gtirb::Module& Module) override;
     void transformImpl(AnalysisPassResult& Result, gtirb::Context& Context,
                        gtirb::Module& Module) override;
 
@@ -68,6 +80,13 @@ private:
     bool SelfDiagnose = false;
     bool IgnoreErrors = false;
     bool NoCfiDirectives = false;
+    bool KeepDecodedInstructions = false;
+
+    // Register operands of the program, read before the run for the decoded instructions.
+    std::map<uint64_t, relations::RegOp> RegOperands;
+
+    // Module data read by the data functors of the program.
+    std::unique_ptr<FunctorContextRegistration> FunctorData;
 
     static std::map<Target, Factory>& loaders();
 };
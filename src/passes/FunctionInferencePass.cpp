@@ -147,12 +147,26 @@ void FunctionInferencePass::loadImpl(AnalysisPassResult& Result, const gtirb::Co
     // Build GTIRB loader.
     CompositeLoader Loader("souffle_function_inference");
     Loader.add(BlocksLoader);
-    Loader.add(CfgLoader);
+    // Take the CFG edges from the previous pass if it has them, instead of walking the CFG.
+    auto* Previous = dynamic_cast<DatalogAnalysisPass*>(PreviousPass);
+    Loader.add([Previous](const gtirb::Module& M, souffle::SouffleProgram& P) {
+        if(!Previous
+           || !Previous->exportRelations({"cfg_edge", "cfg_edge_to_top", "cfg_edge_to_symbol"}, P))
+        {
+            CfgLoader(M, P);
+        }
+    });
     Loader.add(SymbolicExpressionLoader);
 
     // TODO: Add support for ARM64 prologues.
     if(Module.getISA() == gtirb::ISA::X64)
-        Loader.add<CodeBlockLoader<X64Loader>>();
+    {
+        // Reuse the instructions decoded by the disassembly pass if it is part of the pipeline.
+        if(DecodedInstructions)
+            Loader.add(DecodedInstructionLoader{DecodedInstructions});
+        else
+            Loader.add<CodeBlockLoader<X64Loader>>();
+    }
 
     if(Module.getAuxData<gtirb::schema::Padding>())
         Loader.add(PaddingLoader{&Context});
@@ -162,7 +176,7 @@ void FunctionInferencePass::loadImpl(AnalysisPassResult& Result, const gtirb::Co
         Loader.add(FunctionEntriesLoader{&Context});
 
     // Load GTIRB and build program.
-    Program = Loader.load(Module);
+    Program = Loader.load(Module, ThreadCount);
     if(!Program)
     {
         Result.Errors.push_back("Could not create souffle_function_inference program");
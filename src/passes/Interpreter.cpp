@@ -52,15 +52,50 @@ std::string getInterpreterArch(const gtirb::Module &Module)
     return "";
 }
 
-void runInterpreter(const gtirb::IR &IR, const gtirb::Module &Module,
-                    souffle::SouffleProgram &Program, const std::string &DatalogFile,
-                    const std::string &Directory, const std::string &LibDirectory,
-                    const std::string &ProfilePath, uint8_t Threads)
+// Save the part of the module read by the functors of libfunctors.so: an IR with a single
+// module of the same name, holding only the byte order and the bytes of the loaded sections.
+// The symbols, blocks, CFG and aux data of the whole IR are not needed by the functors, and
+// make up most of the cost of saving and loading it on large binaries.
+void saveFunctorModule(const gtirb::Module &Module, const std::string &Path)
 {
-    // Dump the current GTIRB into the debug directory for use by Functors.
-    std::ofstream out(Directory + "/binary.gtirb", std::ios::out | std::ios::binary);
-    IR.save(out);
-    out.close();
+    gtirb::Context Context;
+    gtirb::IR *IR = gtirb::IR::Create(Context);
+    gtirb::Module *Copy = IR->addModule(Context, Module.getName());
+    Copy->setISA(Module.getISA());
+    Copy->setFileFormat(Module.getFileFormat());
+    Copy->setByteOrder(Module.getByteOrder());
+    for(const gtirb::Section &Section : Module.sections())
+    {
+        if(!Section.isFlagSet(gtirb::SectionFlag::Loaded))
+        {
+            continue;
+        }
+        gtirb::Section *SectionCopy = Copy->addSection(Context, Section.getName());
+        for(gtirb::SectionFlag Flag : Section.flags())
+        {
+            SectionCopy->addFlag(Flag);
+        }
+        for(const gtirb::ByteInterval &ByteInterval : Section.byte_intervals())
+        {
+            const uint8_t *Bytes = ByteInterval.rawBytes<const uint8_t>();
+            SectionCopy->addByteInterval(Context, ByteInterval.getAddress(), Bytes,
+                                         Bytes + ByteInterval.getInitializedSize(),
+                                         ByteInterval.getSize(),
+                                         ByteInterval.getInitializedSize());
+        }
+    }
+
+    std::ofstream out(Path, std::ios::out | std::ios::binary);
+    IR->save(out);
+}
+
+void runInterpreter(const gtirb::Module &Module, souffle::SouffleProgram &Program,
+                    const std::string &DatalogFile, const std::string &Directory,
+                    const std::string &LibDirectory, const std::string &ProfilePath,
+                    uint8_t Threads)
+{
+    // Dump the data read by the Functors into the debug directory.
+    saveFunctorModule(Module, Directory + "/binary.gtirb");
 
     // Put the debug directory in an env variable for Functors.
     boost::process::environment Env = boost::this_process::environment();
@@ -27,9 +27,9 @@
 
 #include "../gtirb-decoder/DatalogIO.h"
 
-void runInterpreter(const gtirb::IR& IR, const gtirb::Module& Module,
-                    souffle::SouffleProgram& Program, const std::string& DatalogFile,
-                    const std::string& Directory, const std::string& LibDirectory,
-                    const std::string& ProfilePath, uint8_t Threads);
+void runInterpreter(const gtirb::Module& Module, souffle::SouffleProgram& Program,
+                    const std::string& DatalogFile, const std::string& Directory,
+                    const std::string& LibDirectory, const std::string& ProfilePath,
+                    uint8_t Threads);
 
 #endif // GTIRB_SRC_INTERPRETER_H_
@@ -22,36 +22,97 @@
 //===----------------------------------------------------------------------===//
 #include "NoReturnPass.h"
 
+#include <algorithm>
+#include <unordered_set>
+#include <vector>
+
+#include "../CfgUtils.h"
 #include "../gtirb-decoder/CompositeLoader.h"
 #include "../gtirb-decoder/Relations.h"
 #include "../gtirb-decoder/core/AuxDataLoader.h"
 #include "../gtirb-decoder/core/EdgesLoader.h"
 
+static const std::vector<std::string> CfgEdgeRelations = {"cfg_edge", "cfg_edge_to_top",
+                                                          "cfg_edge_to_symbol"};
+
+void NoReturnPass::analyzeImpl(AnalysisPassResult& Result, const gtirb::Module& Module)
+{
+    // Keep the CFG edges for the next pass.
+    saveRelations(CfgEdgeRelations);
+    DatalogAnalysisPass::analyzeImpl(Result, Module);
+}
+
 void NoReturnPass::transformImpl(AnalysisPassResult& Result, gtirb::Context& Context,
                                  gtirb::Module& Module)
 {
     DatalogAnalysisPass::transformImpl(Result, Context, Module);
 
-    std::set<gtirb::CodeBlock*> NoReturn;
+    std::vector<gtirb::CodeBlock*> NoReturn;
     for(auto& Output : *Program->getRelation("block_call_no_return"))
     {
         gtirb::Addr BlockAddr(Output[0]);
         // this should correspond to only one block
         for(auto& Block : Module.findCodeBlocksOn(BlockAddr))
         {
-            NoReturn.insert(&Block);
+            NoReturn.push_back(&Block);
+        }
+    }
+    std::sort(NoReturn.begin(), NoReturn.end());
+    NoReturn.erase(std::unique(NoReturn.begin(), NoReturn.end()), NoReturn.end());
+
+    // The exported CFG edges leave out the fallthrough edges of the same blocks.
+    NoReturnBlocks = std::make_shared<std::unordered_set<souffle::RamDomain>>();
+    for(gtirb::CodeBlock* Block : NoReturn)
+    {
+        if(std::optional<gtirb::Addr> Addr = Block->getAddress())
+        {
+            NoReturnBlocks->insert(souffle::ramBitCast<souffle::RamDomain>(
+                static_cast<souffle::RamUnsigned>(static_cast<uint64_t>(*Addr))));
         }
     }
+
+    // Only visit the out-edges of the blocks that lose their fallthrough, so that the cost does
+    // not depend on the size of the CFG.
     gtirb::CFG& Cfg = Module.getIR()->getCFG();
-    boost::remove_edge_if(
-        [&](auto Edge) {
-            gtirb::EdgeLabel Label = *static_cast<const gtirb::EdgeLabel*>(Edge.get_property());
-            if(auto* Block = gtirb::dyn_cast<gtirb::CodeBlock>(Cfg[Edge.m_source]))
-                return NoReturn.count(Block) && Label
-                       && std::get<gtirb::EdgeType>(*Label) == gtirb::EdgeType::Fallthrough;
-            return false;
-        },
-        Cfg);
+    for(gtirb::CodeBlock* Block : NoReturn)
+    {
+        if(auto Vertex = getCfgVertex(Cfg, Block))
+        {
+            boost::remove_out_edge_if(
+                *Vertex,
+                [&](const auto& Edge) {
+                    const gtirb::EdgeLabel& Label = Cfg[Edge];
+                    return Label
+                           && std::get<gtirb::EdgeType>(*Label) == gtirb::EdgeType::Fallthrough;
+                },
+                Cfg);
+        }
+    }
+}
+
+std::map<std::string, DatalogAnalysisPass::TupleFilter> NoReturnPass::getExportedRelations()
+{
+    // Leave out the fallthrough edges removed by transformImpl.
+    if(!NoReturnBlocks)
+    {
+        return {};
+    }
+    std::shared_ptr<const std::unordered_set<souffle::RamDomain>> NoReturn = NoReturnBlocks;
+    souffle::RamDomain Fallthrough = Program->getSymbolTable().encode("fallthrough");
+    auto keepEdge = [&](size_t TypeIndex) -> TupleFilter {
+        return [NoReturn, Fallthrough, TypeIndex](const souffle::RamDomain* Edge) {
+            return Edge[TypeIndex] != Fallthrough || NoReturn->count(Edge[0]) == 0;
+        };
+    };
+    return {{"cfg_edge", keepEdge(4)},
+            {"cfg_edge_to_top", keepEdge(3)},
+            {"cfg_edge_to_symbol", keepEdge(4)}};
+}
+
+void NoReturnPass::clear()
+{
+    NoReturnBlocks.reset();
+    DatalogAnalysisPass::clear();
 }
 
 void NoReturnPass::loadImpl(AnalysisPassResult& Result, const gtirb::Context& Context,
@@ -24,6 +24,8 @@
 #define NO_RETURN_PASS_H_
 
 #include <gtirb/gtirb.hpp>
+#include <memory>
+#include <unordered_set>
 
 #include "DatalogAnalysisPass.h"
 
@@ -52,10 +54,19 @@ class NoReturnPass : public DatalogAnalysisPass
         return true;
     }
 
+public:
+    virtual void clear() override;
+
 protected:
     void loadImpl(AnalysisPassResult& Result, const gtirb::Context& Context,
                   const gtirb::Module& Module, AnalysisPass* PreviousPass = nullptr) override;
+    void analyzeImpl(AnalysisPassResult& Result, const gtirb::Module& Module) override;
     void transformImpl(AnalysisPassResult& Result, gtirb::Context& Context,
                        gtirb::Module& Module) override;
+    std::map<std::string, TupleFilter> getExportedRelations() override;
+
+private:
+    // Addresses of the blocks whose fallthrough edges transformImpl removed.
+    std::shared_ptr<std::unordered_set<souffle::RamDomain>> NoReturnBlocks;
 };
 #endif // NO_RETURN_PASS_H_
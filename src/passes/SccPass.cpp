@@ -22,29 +22,147 @@
 //===----------------------------------------------------------------------===//
 #include "SccPass.h"
 
-#include <boost/config.hpp>
-#include <boost/graph/adjacency_list.hpp>
-#include <boost/graph/filtered_graph.hpp>
-#include <boost/graph/graph_utility.hpp>
-#include <boost/graph/strong_components.hpp>
+#include <algorithm>
+#include <boost/range/iterator_range.hpp>
+#include <limits>
+#include <unordered_map>
+#include <vector>
 
 #include "../AuxDataSchema.h"
+#include "../CfgUtils.h"
 
-class KeepIntraProcedural
+namespace
 {
-public:
-    template <typename Edge>
-    bool operator()(const Edge& E) const
+    /**
+    Intra-procedural CFG of a module in compressed sparse row form: the successors of vertex V
+    are Targets[Offsets[V]] to Targets[Offsets[V + 1] - 1].
+    */
+    struct ModuleCfg
     {
-        const gtirb::EdgeLabel& L = *static_cast<const gtirb::EdgeLabel*>(E.get_property());
-        if(L)
+        std::vector<const gtirb::CfgNode*> Nodes;
+        std::vector<uint32_t> Offsets;
+        std::vector<uint32_t> Targets;
+    };
+
+    bool isIntraProcedural(const gtirb::EdgeLabel& Label)
+    {
+        if(Label)
         {
-            gtirb::EdgeType Type = std::get<gtirb::EdgeType>(*L);
+            gtirb::EdgeType Type = std::get<gtirb::EdgeType>(*Label);
             return Type == gtirb::EdgeType::Branch || Type == gtirb::EdgeType::Fallthrough;
         }
         return false;
     }
-};
+
+    /**
+    Number the CFG vertices of the module in the order of getModuleCfgVertices, and keep their
+    branch and fallthrough edges to vertices of the module, in the order of their out-edges.
+    */
+    ModuleCfg buildModuleCfg(const gtirb::CFG& Cfg, const gtirb::Module& Module)
+    {
+        ModuleCfg Graph;
+        std::vector<gtirb::CFG::vertex_descriptor> Vertices = getModuleCfgVertices(Cfg, Module);
+        std::unordered_map<gtirb::CFG::vertex_descriptor, uint32_t> Index;
+        Index.reserve(Vertices.size());
+        for(auto Vertex : Vertices)
+        {
+            Index.emplace(Vertex, static_cast<uint32_t>(Graph.Nodes.size()));
+            Graph.Nodes.push_back(Cfg[Vertex]);
+        }
+
+        Graph.Offsets.reserve(Graph.Nodes.size() + 1);
+        Graph.Offsets.push_back(0);
+        for(auto Vertex : Vertices)
+        {
+            for(auto Edge : boost::make_iterator_range(boost::out_edges(Vertex, Cfg)))
+            {
+                if(!isIntraProcedural(Cfg[Edge]))
+                {
+                    continue;
+                }
+                if(auto It = Index.find(boost::target(Edge, Cfg)); It != Index.end())
+                {
+                    Graph.Targets.push_back(It->second);
+                }
+            }
+            Graph.Offsets.push_back(static_cast<uint32_t>(Graph.Targets.size()));
+        }
+        return Graph;
+    }
+
+    /**
+    Compute the strongly connected components of a graph with an iterative version of
+    Tarjan's algorithm. Components are numbered in the order they are completed, starting the
+    search from the vertices in order, as boost::strong_components does.
+    */
+    std::vector<uint32_t> stronglyConnectedComponents(const ModuleCfg& Graph)
+    {
+        const uint32_t None = std::numeric_limits<uint32_t>::max();
+        size_t Count = Graph.Nodes.size();
+        std::vector<uint32_t> Order(Count, None);
+        std::vector<uint32_t> Low(Count, None);
+        std::vector<uint32_t> Component(Count, None);
+
+        // Vertices visited but not yet assigned to a component.
+        std::vector<uint32_t> Stack;
+        // Depth-first search path, with the next out-edge of each vertex to follow.
+        std::vector<std::pair<uint32_t, uint32_t>> Path;
+
+        uint32_t NextOrder = 0;
+        uint32_t NextComponent = 0;
+        auto visit = [&](uint32_t V) {
+            Order[V] = Low[V] = NextOrder++;
+            Stack.push_back(V);
+            Path.emplace_back(V, Graph.Offsets[V]);
+        };
+
+        for(uint32_t Root = 0; Root < Count; Root++)
+        {
+            if(Order[Root] != None)
+            {
+                continue;
+            }
+            visit(Root);
+            while(!Path.empty())
+            {
+                auto [V, Edge] = Path.back();
+                if(Edge < Graph.Offsets[V + 1])
+                {
+                    Path.back().second++;
+                    uint32_t W = Graph.Targets[Edge];
+                    if(Order[W] == None)
+                    {
+                        visit(W);
+                    }
+                    else if(Component[W] == None)
+                    {
+                        Low[V] = std::min(Low[V], Order[W]);
+                    }
+                    continue;
+                }
+
+                Path.pop_back();
+                if(!Path.empty())
+                {
+                    uint32_t Parent = Path.back().first;
+                    Low[Parent] = std::min(Low[Parent], Low[V]);
+                }
+                if(Low[V] == Order[V])
+                {
+                    uint32_t W;
+                    do
+                    {
+                        W = Stack.back();
+                        Stack.pop_back();
+                        Component[W] = NextComponent;
+                    } while(W != V);
+                    NextComponent++;
+                }
+            }
+        }
+        return Component;
+    }
+} // namespace
 
 void SccPass::loadImpl(AnalysisPassResult& Result, const gtirb::Context& Context,
                        const gtirb::Module& Module, AnalysisPass* PreviousPass)
@@ -53,34 +171,15 @@ void SccPass::loadImpl(AnalysisPassResult& Result, const gtirb::Context& Context
 
 void SccPass::analyzeImpl(AnalysisPassResult& Result, const gtirb::Module& Module)
 {
-    auto& Cfg = Module.getIR()->getCFG();
-    KeepIntraProcedural Filter;
-    boost::filtered_graph<gtirb::CFG, KeepIntraProcedural> CfgFiltered(Cfg, Filter);
-
-    typedef std::map<gtirb::CFG::vertex_descriptor, size_t> PropertyMap;
-
-    // Property map to store SCCs
-    PropertyMap SccComponents;
-    boost::associative_property_map<PropertyMap> SccComponentsMap(SccComponents);
-
-    // Create property map with indexes.
-    // This is needed because we use lists for storing vertices.
-    PropertyMap Index;
-    boost::associative_property_map<PropertyMap> IndexMap(Index);
-    size_t I = 0;
-    for(auto Vertex : boost::make_iterator_range(boost::vertices(Cfg)))
-    {
-        boost::put(IndexMap, Vertex, I++);
-    }
-
-    // Compute the Sccs
-    strong_components(CfgFiltered, SccComponentsMap, vertex_index_map(IndexMap));
+    // Restrict the CFG to the module, so that the result does not depend on
+    // other modules of the IR.
+    ModuleCfg Graph = buildModuleCfg(Module.getIR()->getCFG(), Module);
+    std::vector<uint32_t> Components = stronglyConnectedComponents(Graph);
 
     // Store them in AuxData
-    for(auto Vertex : boost::make_iterator_range(vertices(Cfg)))
+    for(size_t V = 0; V < Graph.Nodes.size(); V++)
     {
-        gtirb::Node* N = Cfg[Vertex];
-        Sccs[N->getUUID()] = SccComponents[Vertex];
+        Sccs[Graph.Nodes[V]->getUUID()] = Components[V];
     }
 }
 
@@ -93,4 +192,5 @@ void SccPass::transformImpl(AnalysisPassResult& Result, gtirb::Context& Context,
 void SccPass::clear()
 {
     Sccs.clear();
+    AnalysisPass::clear();
 }
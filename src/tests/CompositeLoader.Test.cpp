@@ -6,6 +6,7 @@
 #include "../gtirb-builder/GtirbBuilder.h"
 #include "../gtirb-decoder/CompositeLoader.h"
 #include "../gtirb-decoder/DatalogIO.h"
+#include "../gtirb-decoder/arch/X64Loader.h"
 #include "../gtirb-decoder/core/AuxDataLoader.h"
 
 class CompositeLoaderTest : public ::testing::TestWithParam<const char*>
@@ -58,3 +59,58 @@ TEST_P(CompositeLoaderTest, build_test_loader)
 
 INSTANTIATE_TEST_SUITE_P(GtirbDecoderTests, CompositeLoaderTest,
                          testing::Values("inputs/hello.x64.elf"));
+
+static std::vector<std::vector<souffle::RamDomain>> relationTuples(
+    souffle::SouffleProgram& Program, const std::string& Name)
+{
+    std::vector<std::vector<souffle::RamDomain>> Tuples;
+    souffle::Relation* Relation = Program.getRelation(Name);
+    for(auto& Tuple : *Relation)
+    {
+        std::vector<souffle::RamDomain> Values;
+        for(size_t I = 0; I < Relation->getArity(); I++)
+        {
+            Values.push_back(Tuple[I]);
+        }
+        Tuples.push_back(Values);
+    }
+    return Tuples;
+}
+
+TEST(InstructionLoaderTest, parallel_load)
+{
+    gtirb::Context Context;
+    gtirb::Module* Module = gtirb::Module::Create(Context, "test");
+    Module->setISA(gtirb::ISA::X64);
+    Module->setByteOrder(gtirb::ByteOrder::Little);
+
+    // Enough pseudo-random bytes for several decode ranges, in two byte intervals.
+    std::vector<uint8_t> Bytes(300000);
+    uint32_t State = 1;
+    for(uint8_t& Byte : Bytes)
+    {
+        State = State * 1103515245 + 12345;
+        Byte = static_cast<uint8_t>(State >> 16);
+    }
+    gtirb::Section* Section = Module->addSection(Context, ".text");
+    Section->addFlag(gtirb::SectionFlag::Executable);
+    Section->addByteInterval(Context, gtirb::Addr(0x10000), Bytes.begin(), Bytes.begin() + 200000,
+                             200000, 200000);
+    Section->addByteInterval(Context, gtirb::Addr(0x100000), Bytes.begin() + 200000, Bytes.end(),
+                             100000, 100000);
+
+    CompositeLoader Loader("souffle_disasm_x86_64");
+    Loader.add<X64Loader>();
+    std::unique_ptr<souffle::SouffleProgram> Sequential = Loader.load(*Module, 1);
+    std::unique_ptr<souffle::SouffleProgram> Parallel = Loader.load(*Module, 8);
+    ASSERT_TRUE(Sequential && Parallel);
+
+    for(const char* Name : {"instruction", "invalid_op_code", "op_immediate", "op_regdirect",
+                            "op_indirect", "register_access", "instruction_op_access"})
+    {
+        SCOPED_TRACE(Name);
+        auto Expected = relationTuples(*Sequential, Name);
+        EXPECT_FALSE(Expected.empty());
+        EXPECT_EQ(relationTuples(*Parallel, Name), Expected);
+    }
+}
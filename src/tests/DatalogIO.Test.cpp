@@ -72,3 +72,72 @@ TEST(DatalogIOTest, TestInsertTuple)
     // Confirm that the output matches the input.
     ASSERT_EQ(TupleText, OutputStream.str());
 }
+
+TEST(DatalogIOTest, TestBinaryRelation)
+{
+    auto Program = std::unique_ptr<souffle::SouffleProgram>(
+        souffle::ProgramFactory::newInstance("souffle_disasm_arm64"));
+
+    souffle::Relation *Relation = Program->getRelation("stack_def_use.def_used");
+    DatalogIO::insertTuple("0x778\t[SP, 16]\t0x7ac\t[SP, 16]\t1\n", *Program, Relation);
+    DatalogIO::insertTuple("0x7b0\t[X29, 8]\t0x7c4\t[SP, 16]\t2\n", *Program, Relation);
+
+    std::stringstream Expected("");
+    DatalogIO::writeRelation(Expected, *Program, Relation);
+
+    for(bool Compress : {false, true})
+    {
+        std::stringstream Binary("");
+        DatalogIO::writeBinaryRelation(Binary, *Program, Relation, Compress);
+
+        // Read the relation back into a new program, with its own symbol and record tables.
+        auto Copy = std::unique_ptr<souffle::SouffleProgram>(
+            souffle::ProgramFactory::newInstance("souffle_disasm_arm64"));
+        souffle::Relation *CopyRelation = Copy->getRelation("stack_def_use.def_used");
+        ASSERT_TRUE(DatalogIO::readBinaryRelation(Binary, *Copy, CopyRelation));
+        ASSERT_EQ(CopyRelation->size(), 2u);
+
+        std::stringstream Output("");
+        DatalogIO::writeRelation(Output, *Copy, CopyRelation);
+        ASSERT_EQ(Expected.str(), Output.str());
+    }
+
+    // A relation of other types is rejected.
+    std::stringstream Binary("");
+    DatalogIO::writeBinaryRelation(Binary, *Program, Relation, false);
+    souffle::Relation *Other = Program->getRelation("instruction");
+    ASSERT_FALSE(DatalogIO::readBinaryRelation(Binary, *Program, Other));
+    ASSERT_EQ(Other->size(), 0u);
+}
+
+TEST(DatalogIOTest, TestRelationFilter)
+{
+    ASSERT_TRUE(DatalogIO::matchGlob("*.value_reg", "disassembly.value_reg"));
+    ASSERT_FALSE(DatalogIO::matchGlob("*.value_reg", "disassembly.best_value_reg"));
+    ASSERT_TRUE(DatalogIO::matchGlob("disassembly.*", "disassembly.stack_def_use.def_used"));
+    ASSERT_TRUE(DatalogIO::matchGlob("code_in_?*_block", "code_in_refined_block"));
+    ASSERT_FALSE(DatalogIO::matchGlob("code_in_?*_block", "code_in__block"));
+
+    DatalogIO::RelationFilter Filter;
+    ASSERT_TRUE(Filter.selectsAll());
+    ASSERT_TRUE(Filter.selects("disassembly", "instruction"));
+
+    Filter.select("disassembly.*");
+    Filter.select("*.value_reg");
+    Filter.exclude("*.instruction*");
+    ASSERT_FALSE(Filter.selectsAll());
+    ASSERT_TRUE(Filter.selects("disassembly", "symbolic_operand"));
+    ASSERT_TRUE(Filter.selects("no-return-analysis", "value_reg"));
+    ASSERT_FALSE(Filter.selects("no-return-analysis", "block"));
+    ASSERT_FALSE(Filter.selects("disassembly", "instruction_get_op"));
+
+    auto Program = std::unique_ptr<souffle::SouffleProgram>(
+        souffle::ProgramFactory::newInstance("souffle_disasm_arm64"));
+    std::vector<souffle::Relation *> Selected =
+        Filter.select(Program->getInputRelations(), "disassembly");
+    ASSERT_FALSE(Selected.empty());
+    for(souffle::Relation *Relation : Selected)
+    {
+        ASSERT_NE(Relation->getName().rfind("instruction", 0), 0u);
+    }
+}
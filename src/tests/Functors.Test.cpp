@@ -1,7 +1,10 @@
 #include <gtest/gtest.h>
 
+#include <atomic>
 #include <fstream>
 #include <gtirb/gtirb.hpp>
+#include <souffle/datastructure/SymbolTableImpl.h>
+#include <thread>
 
 #include "../Functors.h"
 
@@ -19,3 +22,157 @@ TEST(Thumb32BranchOffsetTest, read_branch_offset)
     //
     EXPECT_EQ(functor_thumb32_branch_offset(0xfffef7ff), -4);
 }
+
+TEST(FunctorDataTest, read_data)
+{
+    gtirb::Context Ctx;
+    gtirb::IR* IR = gtirb::IR::Create(Ctx);
+    gtirb::Module* M = IR->addModule(Ctx, "test");
+    M->setByteOrder(gtirb::ByteOrder::Little);
+
+    std::vector<uint8_t> Bytes = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08};
+
+    gtirb::Section* Data = M->addSection(Ctx, ".data");
+    Data->addFlag(gtirb::SectionFlag::Loaded);
+    Data->addFlag(gtirb::SectionFlag::Initialized);
+    // Only the first 6 bytes are initialized.
+    Data->addByteInterval(Ctx, gtirb::Addr(0x1000), Bytes.begin(), Bytes.end(), 8, 6);
+
+    gtirb::Section* Text = M->addSection(Ctx, ".text");
+    Text->addFlag(gtirb::SectionFlag::Loaded);
+    Text->addFlag(gtirb::SectionFlag::Executable);
+    Text->addByteInterval(Ctx, gtirb::Addr(0x2000), Bytes.begin(), Bytes.end(), 8, 8);
+
+    gtirb::Section* Comment = M->addSection(Ctx, ".comment");
+    Comment->addFlag(gtirb::SectionFlag::Initialized);
+    Comment->addByteInterval(Ctx, gtirb::Addr(0x3000), Bytes.begin(), Bytes.end(), 8, 8);
+
+    FunctorContext.useModule(M);
+
+    EXPECT_EQ(functor_data_u8(0x1000), 0x01);
+    EXPECT_EQ(functor_data_u16(0x1001), 0x0302);
+    EXPECT_EQ(functor_data_u32(0x1002), 0x06050403);
+    EXPECT_EQ(functor_data_u32(0x2004), 0x08070605);
+    EXPECT_EQ(functor_data_u64(0x2000), 0x0807060504030201);
+    EXPECT_EQ(functor_data_s8(0x2007), 0x08);
+
+    // Reads past the initialized bytes, in gaps, or in sections that are not
+    // loaded are invalid.
+    EXPECT_EQ(functor_data_valid(nullptr, nullptr, 0x1002, 4), 1);
+    EXPECT_EQ(functor_data_valid(nullptr, nullptr, 0x1003, 4), 0);
+    EXPECT_EQ(functor_data_u32(0x1003), 0);
+    EXPECT_EQ(functor_data_valid(nullptr, nullptr, 0x0fff, 1), 0);
+    EXPECT_EQ(functor_data_valid(nullptr, nullptr, 0x2008, 1), 0);
+    EXPECT_EQ(functor_data_valid(nullptr, nullptr, 0x3000, 1), 0);
+    EXPECT_EQ(functor_data_valid(nullptr, nullptr, 0x1000, 3), 0);
+}
+
+TEST(FunctorDataTest, read_data_overlapping)
+{
+    gtirb::Context Ctx;
+    gtirb::IR* IR = gtirb::IR::Create(Ctx);
+    gtirb::Module* M = IR->addModule(Ctx, "test");
+    M->setByteOrder(gtirb::ByteOrder::Big);
+
+    std::vector<uint8_t> Bytes1 = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08};
+    std::vector<uint8_t> Bytes2 = {0x11, 0x12};
+
+    gtirb::Section* Data = M->addSection(Ctx, ".data");
+    Data->addFlag(gtirb::SectionFlag::Loaded);
+    Data->addFlag(gtirb::SectionFlag::Initialized);
+    Data->addByteInterval(Ctx, gtirb::Addr(0x1000), Bytes1.begin(), Bytes1.end(), 8, 8);
+
+    gtirb::Section* Overlay = M->addSection(Ctx, ".overlay");
+    Overlay->addFlag(gtirb::SectionFlag::Loaded);
+    Overlay->addFlag(gtirb::SectionFlag::Initialized);
+    Overlay->addByteInterval(Ctx, gtirb::Addr(0x1002), Bytes2.begin(), Bytes2.end(), 2, 2);
+
+    FunctorContext.useModule(M);
+
+    // Reads that only fit in the enclosing interval are still found.
+    EXPECT_EQ(functor_data_u32(0x1002), 0x03040506);
+    EXPECT_EQ(functor_data_u32(0x1004), 0x05060708);
+    EXPECT_EQ(functor_data_valid(nullptr, nullptr, 0x1006, 4), 0);
+}
+
+TEST(FunctorDataTest, concurrent_programs)
+{
+    // Several modules with different contents, each read through the symbol
+    // table of a different program.
+    constexpr size_t ModuleCount = 8;
+    constexpr size_t ThreadCount = 16;
+    constexpr uint64_t Size = 0x1000;
+
+    gtirb::Context Ctx;
+    gtirb::IR* IR = gtirb::IR::Create(Ctx);
+    std::vector<gtirb::Module*> Modules;
+    std::vector<std::unique_ptr<souffle::SymbolTableImpl>> SymbolTables;
+    std::vector<std::unique_ptr<FunctorContextRegistration>> Registrations;
+    for(size_t I = 0; I < ModuleCount; I++)
+    {
+        gtirb::Module* M = IR->addModule(Ctx, "test" + std::to_string(I));
+        M->setByteOrder(gtirb::ByteOrder::Little);
+        std::vector<uint8_t> Bytes(Size, static_cast<uint8_t>(I + 1));
+        gtirb::Section* S = M->addSection(Ctx, ".data");
+        S->addFlag(gtirb::SectionFlag::Loaded);
+        S->addFlag(gtirb::SectionFlag::Initialized);
+        // Modules are at different addresses, except for two that overlap.
+        S->addByteInterval(Ctx, gtirb::Addr((I % (ModuleCount - 1)) * Size), Bytes.begin(),
+                           Bytes.end(), Size, Size);
+        Modules.push_back(M);
+
+        SymbolTables.push_back(std::make_unique<souffle::SymbolTableImpl>());
+        Registrations.push_back(std::make_unique<FunctorContextRegistration>(*SymbolTables[I], *M));
+    }
+
+    std::atomic<size_t> Errors(0);
+    std::atomic<bool> Done(false);
+
+    // Keep registering and releasing unrelated contexts while reading.
+    std::thread Churn([&]() {
+        souffle::SymbolTableImpl Other;
+        while(!Done)
+        {
+            FunctorContextRegistration Registration(Other, *Modules[0]);
+        }
+    });
+
+    std::vector<std::thread> Readers;
+    for(size_t T = 0; T < ThreadCount; T++)
+    {
+        Readers.emplace_back([&, T]() {
+            for(uint64_t I = 0; I < 100000; I++)
+            {
+                size_t M = (T + I) % ModuleCount;
+                uint64_t Base = (M % (ModuleCount - 1)) * Size;
+                uint64_t Expected = (M + 1) * 0x01010101;
+                souffle::RamDomain EA = Base + (I * 4) % Size;
+                souffle::RamDomain Value =
+                    functor_data_unsigned(SymbolTables[M].get(), nullptr, EA, 4);
+                if(functor_data_valid(SymbolTables[M].get(), nullptr, EA, 4) != 1
+                   || static_cast<uint64_t>(Value) != Expected)
+                {
+                    Errors++;
+                }
+            }
+        });
+    }
+    for(std::thread& Reader : Readers)
+    {
+        Reader.join();
+    }
+    Done = true;
+    Churn.join();
+
+    EXPECT_EQ(Errors, 0);
+}
+
+TEST(FunctorDataTest, unregistered_program)
+{
+    // A synthesized program whose context is not registered must not read the default one.
+    souffle::SymbolTableImpl Unregistered;
+    EXPECT_DEATH(functor_data_unsigned(&Unregistered, nullptr, 0x1000, 4),
+                 "without a registered functor context");
+    EXPECT_DEATH(functor_data_valid(&Unregistered, nullptr, 0x1000, 4),
+                 "without a registered functor context");
+}
@@ -4,8 +4,13 @@
 #include <gtirb/gtirb.hpp>
 
 #include "../AuxDataSchema.h"
+#include "../ModuleScheduler.h"
 #include "../Registration.h"
+#include "../gtirb-decoder/core/InstructionLoader.h"
 #include "../passes/DisassemblyPass.h"
+#include "../passes/FunctionInferencePass.h"
+#include "../passes/NoReturnPass.h"
+#include "../passes/SccPass.h"
 
 namespace fs = boost::filesystem;
 
@@ -14,7 +19,7 @@ struct GTIRB
     std::unique_ptr<gtirb::Context> Context;
     gtirb::IR *IR;
     gtirb::Module *Module;
-    DisassemblyPass Disassembler;
+    DisassemblyPass Disassembler{false, false, false, true};
 };
 
 GTIRB buildGtirb(gtirb::ISA ISA, std::vector<uint8_t> &Bytes)
@@ -331,3 +336,94 @@ TEST(ArchMemoryAccessRelation, Arm32)
 
     EXPECT_EQ(Count, ExpectedMemoryAccesses.size());
 }
+
+TEST(DecodedInstructions, X64)
+{
+    std::vector<uint8_t> Bytes = {
+        0x48, 0x89, 0xE5, // 0x10000: mov rbp, rsp
+        0x8B, 0x45, 0x08, // 0x10003: mov eax, dword ptr [rbp + 8]
+        0x74, 0x03,       // 0x10006: je 0x1000b
+        0x83, 0xC0, 0x01, // 0x10008: add eax, 1
+        0xC3              // 0x1000B: ret
+    };
+    GTIRB Gtirb = buildGtirb(gtirb::ISA::X64, Bytes);
+    runSouffle(Gtirb);
+
+    std::shared_ptr<const BinaryFacts> Facts = Gtirb.Disassembler.getDecodedInstructions();
+    ASSERT_TRUE(Facts);
+
+    // Only the first instruction of each code block is kept.
+    std::set<gtirb::Addr> BlockAddrs;
+    for(const auto &Block : Gtirb.Module->code_blocks())
+    {
+        BlockAddrs.insert(*Block.getAddress());
+    }
+    std::set<gtirb::Addr> InstructionAddrs;
+    for(const relations::Instruction &Instruction : Facts->Instructions.instructions())
+    {
+        InstructionAddrs.insert(Instruction.Addr);
+    }
+    EXPECT_EQ(InstructionAddrs, BlockAddrs);
+
+    // Operand indices refer to the kept operands.
+    std::map<uint64_t, std::string> Registers;
+    for(const auto &[Reg, Index] : Facts->Operands.reg())
+    {
+        Registers[Index] = Reg;
+    }
+    const relations::Instruction &First = Facts->Instructions.instructions().front();
+    EXPECT_EQ(First.Addr, gtirb::Addr(0x10000));
+    EXPECT_EQ(First.Name, "MOV");
+    ASSERT_EQ(First.OpCodes.size(), 2u);
+    EXPECT_EQ(Registers[First.OpCodes[0]], "RSP");
+    EXPECT_EQ(Registers[First.OpCodes[1]], "RBP");
+}
+
+// Record whether each pass of a pipeline holds decoded instructions when it ends.
+class DecodedInstructionsListener : public AnalysisPipelineListener
+{
+public:
+    void notifyPassBegin(const AnalysisPass &) override
+    {
+    }
+    void notifyPassEnd(const AnalysisPass &Pass) override
+    {
+        Received[Pass.getName()] = Pass.getDecodedInstructions() != nullptr;
+    }
+    void notifyPassPhase(AnalysisPassPhase, bool) override
+    {
+    }
+    void notifyPassResult(AnalysisPassPhase, const AnalysisPassResult &) override
+    {
+    }
+
+    std::map<std::string, bool> Received;
+};
+
+TEST(DecodedInstructions, Pipeline)
+{
+    std::vector<uint8_t> Bytes = {
+        0x48, 0x89, 0xE5, // 0x10000: mov rbp, rsp
+        0x8B, 0x45, 0x08, // 0x10003: mov eax, dword ptr [rbp + 8]
+        0x74, 0x03,       // 0x10006: je 0x1000b
+        0x83, 0xC0, 0x01, // 0x10008: add eax, 1
+        0xC3              // 0x1000B: ret
+    };
+    GTIRB Gtirb = buildGtirb(gtirb::ISA::X64, Bytes);
+
+    auto Listener = std::make_shared<DecodedInstructionsListener>();
+    ModuleScheduler Scheduler(1, [&](AnalysisPipeline &Pipeline) {
+        Pipeline.push<DisassemblyPass>(false, false, false, true);
+        Pipeline.push<SccPass>();
+        Pipeline.push<NoReturnPass>();
+        Pipeline.push<FunctionInferencePass>();
+        Pipeline.addListener(Listener);
+    });
+    Scheduler.run(*Gtirb.Context, *Gtirb.IR);
+
+    // The facts are passed on through the SCC pass, which has no load phase.
+    EXPECT_TRUE(Listener->Received["disassembly"]);
+    EXPECT_TRUE(Listener->Received["SCC analysis"]);
+    EXPECT_TRUE(Listener->Received["no return analysis"]);
+    EXPECT_TRUE(Listener->Received["function inference"]);
+}
@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+
+#include <gtirb/gtirb.hpp>
+
+#include "../AuxDataSchema.h"
+#include "../CliDriver.h"
+#include "../ModuleScheduler.h"
+#include "../passes/SccPass.h"
+
+TEST(Unit_ModuleScheduler, thread_budget)
+{
+    ThreadBudget Budget = splitThreadBudget(8, 0, 400);
+    EXPECT_EQ(Budget.ModuleWorkers, 8U);
+    EXPECT_EQ(Budget.DatalogThreads, 1U);
+
+    Budget = splitThreadBudget(8, 0, 1);
+    EXPECT_EQ(Budget.ModuleWorkers, 1U);
+    EXPECT_EQ(Budget.DatalogThreads, 8U);
+
+    Budget = splitThreadBudget(16, 4, 400);
+    EXPECT_EQ(Budget.ModuleWorkers, 4U);
+    EXPECT_EQ(Budget.DatalogThreads, 4U);
+
+    Budget = splitThreadBudget(1, 0, 400);
+    EXPECT_EQ(Budget.ModuleWorkers, 1U);
+    EXPECT_EQ(Budget.DatalogThreads, 1U);
+}
+
+static std::vector<int64_t> runScc(unsigned int Workers)
+{
+    gtirb::Context Ctx;
+    gtirb::IR* IR = gtirb::IR::Create(Ctx);
+    gtirb::EdgeLabel SimpleJump = std::make_tuple(
+        gtirb::ConditionalEdge::OnFalse, gtirb::DirectEdge::IsDirect, gtirb::EdgeType::Branch);
+
+    std::vector<std::pair<gtirb::Module*, gtirb::CodeBlock*>> Blocks;
+    for(int I = 0; I < 16; I++)
+    {
+        gtirb::Module* M = IR->addModule(Ctx, "test" + std::to_string(I));
+        gtirb::ByteInterval* BI = M->addSection(Ctx, "")->addByteInterval(Ctx, gtirb::Addr(0), 8);
+
+        // A chain of blocks with a loop whose size depends on the module.
+        std::vector<gtirb::CodeBlock*> Chain;
+        for(int J = 0; J < 8; J++)
+        {
+            Chain.push_back(BI->addBlock<gtirb::CodeBlock>(Ctx, J, 1));
+            Blocks.push_back({M, Chain.back()});
+        }
+        gtirb::CFG& Cfg = IR->getCFG();
+        for(int J = 0; J + 1 < 8; J++)
+        {
+            Cfg[*addEdge(Chain[J], Chain[J + 1], Cfg)] = SimpleJump;
+        }
+        Cfg[*addEdge(Chain[7], Chain[I % 8], Cfg)] = SimpleJump;
+    }
+
+    ModuleScheduler Scheduler(Workers,
+                              [](AnalysisPipeline& Pipeline) { Pipeline.push<SccPass>(); });
+    Scheduler.run(Ctx, *IR);
+
+    std::vector<int64_t> Result;
+    for(auto [M, B] : Blocks)
+    {
+        Result.push_back(M->getAuxData<gtirb::schema::Sccs>()->at(B->getUUID()));
+    }
+    return Result;
+}
+
+TEST(Unit_ModuleScheduler, concurrent_matches_sequential)
+{
+    EXPECT_EQ(runScc(4), runScc(1));
+}
+
+TEST(Unit_ModuleScheduler, pass_report)
+{
+    gtirb::Context Ctx;
+    gtirb::IR* IR = gtirb::IR::Create(Ctx);
+    IR->addModule(Ctx, "first");
+    IR->addModule(Ctx, "second");
+
+    auto Report = std::make_shared<PipelineReport>("test-version");
+    ModuleScheduler Scheduler(2, [&](AnalysisPipeline& Pipeline) {
+        Pipeline.push<SccPass>();
+        Pipeline.addListener(std::make_shared<ReportPipelineListener>(Report));
+    });
+    Scheduler.run(Ctx, *IR);
+
+    std::stringstream Out;
+    Report->write(Out);
+    std::string Json = Out.str();
+    EXPECT_NE(Json.find("\"version\": \"test-version\""), std::string::npos);
+    EXPECT_NE(Json.find("{\"name\": \"first\""), std::string::npos);
+    EXPECT_NE(Json.find("{\"name\": \"second\""), std::string::npos);
+    EXPECT_NE(Json.find("\"name\": \"SCC analysis\", \"threads\": 1, \"compute\": {"),
+              std::string::npos);
+    EXPECT_EQ(Json.find("input_tuples"), std::string::npos);
+}
@@ -4,6 +4,8 @@
 #include <gtirb/gtirb.hpp>
 
 #include "../AnalysisPipeline.h"
+#include "../gtirb-decoder/DatalogIO.h"
+#include "../gtirb-decoder/core/EdgesLoader.h"
 #include "../passes/NoReturnPass.h"
 #include "../passes/SccPass.h"
 
@@ -277,3 +279,173 @@ TEST(Unit_NoReturnPass, loop_no_return)
 
     EXPECT_EQ(7, Cfg.m_edges.size());
 }
+
+TEST(Unit_NoReturnPass, module_scope)
+{
+    gtirb::Context Ctx;
+    gtirb::IR* IR = gtirb::IR::Create(Ctx);
+    gtirb::CFG& Cfg = IR->getCFG();
+
+    // Two modules calling exit, of which only the second is analyzed.
+    std::vector<std::pair<gtirb::CodeBlock*, gtirb::CodeBlock*>> Fallthroughs;
+    std::vector<gtirb::Module*> Modules;
+    for(const char* Name : {"test1", "test2"})
+    {
+        gtirb::Module* M = IR->addModule(Ctx, Name);
+        gtirb::ByteInterval* I = M->addSection(Ctx, "")->addByteInterval(Ctx, gtirb::Addr(0), 2);
+        gtirb::CodeBlock* B1 = I->addBlock<gtirb::CodeBlock>(Ctx, 0, 1);
+        gtirb::CodeBlock* B2 = I->addBlock<gtirb::CodeBlock>(Ctx, 1, 1);
+
+        auto ExternalBlock = gtirb::ProxyBlock::Create(Ctx);
+        M->addProxyBlock(ExternalBlock);
+        M->addSymbol(Ctx, "exit")->setReferent(ExternalBlock);
+
+        Cfg[*addEdge(B1, B2, Cfg)] = simpleFallthrough();
+        Cfg[*addEdge(B1, ExternalBlock, Cfg)] = simpleCall();
+        Fallthroughs.emplace_back(B1, B2);
+        Modules.push_back(M);
+    }
+
+    AnalysisPipeline Pipeline;
+    Pipeline.push<SccPass>();
+    Pipeline.push<NoReturnPass>();
+    Pipeline.run(Ctx, *Modules[1]);
+
+    EXPECT_TRUE(edgeIn(Cfg, Fallthroughs[0].first, Fallthroughs[0].second));
+    EXPECT_FALSE(edgeIn(Cfg, Fallthroughs[1].first, Fallthroughs[1].second));
+}
+
+static std::set<std::string> relationRows(souffle::SouffleProgram& Program,
+                                          const std::string& Name)
+{
+    std::stringstream Stream;
+    DatalogIO::writeRelation(Stream, Program, Program.getRelation(Name));
+    std::set<std::string> Rows;
+    for(std::string Row; std::getline(Stream, Row);)
+    {
+        Rows.insert(Row);
+    }
+    return Rows;
+}
+
+TEST(Unit_NoReturnPass, export_cfg_edges)
+{
+    gtirb::Context Ctx;
+    gtirb::IR* IR = gtirb::IR::Create(Ctx);
+    gtirb::Module* M = IR->addModule(Ctx, "test");
+    gtirb::Section* S = M->addSection(Ctx, "");
+    gtirb::ByteInterval* I = S->addByteInterval(Ctx, gtirb::Addr(0), 3);
+
+    gtirb::CodeBlock* B1 = I->addBlock<gtirb::CodeBlock>(Ctx, 0, 1);
+    gtirb::CodeBlock* B2 = I->addBlock<gtirb::CodeBlock>(Ctx, 1, 1);
+    gtirb::CodeBlock* B3 = I->addBlock<gtirb::CodeBlock>(Ctx, 2, 1);
+
+    auto ExternalBlock = gtirb::ProxyBlock::Create(Ctx);
+    M->addProxyBlock(ExternalBlock);
+
+    auto Symbol = M->addSymbol(Ctx, "exit");
+    Symbol->setReferent(ExternalBlock);
+
+    auto TopBlock = gtirb::ProxyBlock::Create(Ctx);
+    M->addProxyBlock(TopBlock);
+
+    gtirb::CFG& Cfg = M->getIR()->getCFG();
+
+    Cfg[*addEdge(B1, B2, Cfg)] = simpleFallthrough();
+    Cfg[*addEdge(B1, ExternalBlock, Cfg)] = simpleCall();
+    Cfg[*addEdge(B2, B3, Cfg)] = simpleFallthrough();
+    Cfg[*addEdge(B3, TopBlock, Cfg)] = simpleReturn();
+
+    SccPass Scc;
+    Scc.load(Ctx, *M);
+    Scc.analyze(*M);
+    Scc.transform(Ctx, *M);
+
+    NoReturnPass NoReturn;
+    NoReturn.load(Ctx, *M, &Scc);
+    NoReturn.analyze(*M);
+    NoReturn.transform(Ctx, *M);
+    EXPECT_FALSE(edgeIn(Cfg, B1, B2));
+
+    // The exported edges are those of the refined CFG.
+    std::vector<std::string> Relations = {"cfg_edge", "cfg_edge_to_top", "cfg_edge_to_symbol"};
+    std::unique_ptr<souffle::SouffleProgram> Exported(
+        souffle::ProgramFactory::newInstance("souffle_no_return"));
+    std::unique_ptr<souffle::SouffleProgram> Loaded(
+        souffle::ProgramFactory::newInstance("souffle_no_return"));
+    ASSERT_TRUE(NoReturn.exportRelations(Relations, *Exported));
+    CfgLoader(*M, *Loaded);
+
+    for(const std::string& Relation : Relations)
+    {
+        EXPECT_EQ(relationRows(*Exported, Relation), relationRows(*Loaded, Relation)) << Relation;
+    }
+    EXPECT_EQ(1, relationRows(*Exported, "cfg_edge").size());
+
+    // Relations that the pass does not export are not copied.
+    EXPECT_FALSE(NoReturn.exportRelations({"in_scc"}, *Exported));
+    EXPECT_EQ(0, Exported->getRelation("in_scc")->size());
+
+    // The edges are not outputs, so they are left out of the Souffle outputs.
+    for(souffle::Relation* Relation : NoReturn.getProgram().getOutputRelations())
+    {
+        EXPECT_EQ(Relation->getName().rfind("cfg_edge", 0), std::string::npos)
+            << Relation->getName();
+    }
+}
+
+TEST(Unit_NoReturnPass, export_cfg_edges_overlapping_blocks)
+{
+    gtirb::Context Ctx;
+    gtirb::IR* IR = gtirb::IR::Create(Ctx);
+    gtirb::Module* M = IR->addModule(Ctx, "test");
+    gtirb::Section* S = M->addSection(Ctx, "");
+    gtirb::ByteInterval* I = S->addByteInterval(Ctx, gtirb::Addr(0), 3);
+
+    // B1 overlaps B2, which calls exit: the transform removes the fallthrough edges of both.
+    gtirb::CodeBlock* B1 = I->addBlock<gtirb::CodeBlock>(Ctx, 0, 2);
+    gtirb::CodeBlock* B2 = I->addBlock<gtirb::CodeBlock>(Ctx, 1, 1);
+    gtirb::CodeBlock* B3 = I->addBlock<gtirb::CodeBlock>(Ctx, 2, 1);
+
+    auto ExternalBlock = gtirb::ProxyBlock::Create(Ctx);
+    M->addProxyBlock(ExternalBlock);
+
+    auto Symbol = M->addSymbol(Ctx, "exit");
+    Symbol->setReferent(ExternalBlock);
+
+    auto TopBlock = gtirb::ProxyBlock::Create(Ctx);
+    M->addProxyBlock(TopBlock);
+
+    gtirb::CFG& Cfg = M->getIR()->getCFG();
+
+    Cfg[*addEdge(B1, B3, Cfg)] = simpleFallthrough();
+    Cfg[*addEdge(B2, B3, Cfg)] = simpleFallthrough();
+    Cfg[*addEdge(B2, ExternalBlock, Cfg)] = simpleCall();
+    Cfg[*addEdge(B3, TopBlock, Cfg)] = simpleReturn();
+
+    SccPass Scc;
+    Scc.load(Ctx, *M);
+    Scc.analyze(*M);
+    Scc.transform(Ctx, *M);
+
+    NoReturnPass NoReturn;
+    NoReturn.load(Ctx, *M, &Scc);
+    NoReturn.analyze(*M);
+    NoReturn.transform(Ctx, *M);
+    EXPECT_FALSE(edgeIn(Cfg, B1, B3));
+    EXPECT_FALSE(edgeIn(Cfg, B2, B3));
+
+    // The exported edges are still those of the refined CFG.
+    std::vector<std::string> Relations = {"cfg_edge", "cfg_edge_to_top", "cfg_edge_to_symbol"};
+    std::unique_ptr<souffle::SouffleProgram> Exported(
+        souffle::ProgramFactory::newInstance("souffle_no_return"));
+    std::unique_ptr<souffle::SouffleProgram> Loaded(
+        souffle::ProgramFactory::newInstance("souffle_no_return"));
+    ASSERT_TRUE(NoReturn.exportRelations(Relations, *Exported));
+    CfgLoader(*M, *Loaded);
+
+    for(const std::string& Relation : Relations)
+    {
+        EXPECT_EQ(relationRows(*Exported, Relation), relationRows(*Loaded, Relation)) << Relation;
+    }
+}
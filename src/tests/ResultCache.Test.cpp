@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <gtirb/gtirb.hpp>
+
+#include "../ResultCache.h"
+
+namespace fs = boost::filesystem;
+
+class ResultCacheTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        Dir = fs::temp_directory_path() / fs::unique_path();
+        fs::create_directories(Dir);
+        Input = (Dir / "input.bin").string();
+        writeInput("\x7f"
+                   "ELF binary contents");
+    }
+
+    void TearDown() override
+    {
+        fs::remove_all(Dir);
+    }
+
+    void writeInput(const std::string& Contents)
+    {
+        std::ofstream Out(Input, std::ios::out | std::ios::binary);
+        Out << Contents;
+    }
+
+    std::string keyFor(const std::string& Version, const std::string& Option)
+    {
+        ResultCache Cache((Dir / "cache").string(), Version);
+        EXPECT_TRUE(Cache.addFile(Input));
+        Cache.addOption("skip-function-analysis", Option);
+        return Cache.key();
+    }
+
+    fs::path Dir;
+    std::string Input;
+};
+
+TEST_F(ResultCacheTest, key_depends_on_inputs)
+{
+    std::string Key = keyFor("1.9.1", "0");
+    EXPECT_EQ(Key, keyFor("1.9.1", "0"));
+    EXPECT_NE(Key, keyFor("1.9.2", "0"));
+    EXPECT_NE(Key, keyFor("1.9.1", "1"));
+
+    writeInput("\x7f"
+               "ELF binary contentz");
+    EXPECT_NE(Key, keyFor("1.9.1", "0"));
+
+    ResultCache Missing((Dir / "cache").string(), "1.9.1");
+    EXPECT_FALSE(Missing.addFile((Dir / "missing.bin").string()));
+}
+
+TEST_F(ResultCacheTest, key_depends_on_input_path)
+{
+    // The same bytes under another name produce a module with another name.
+    std::string Copy = (Dir / "input-copy.bin").string();
+    fs::copy_file(Input, Copy);
+
+    ResultCache Cache((Dir / "cache").string(), "1.9.1");
+    ASSERT_TRUE(Cache.addInput(Input));
+    ResultCache CopyCache((Dir / "cache").string(), "1.9.1");
+    ASSERT_TRUE(CopyCache.addInput(Copy));
+    EXPECT_NE(Cache.key(), CopyCache.key());
+
+    gtirb::Context Context;
+    gtirb::IR* IR = gtirb::IR::Create(Context);
+    IR->addModule(Context, "input.bin");
+    ASSERT_TRUE(Cache.store(*IR));
+
+    gtirb::Context CopyContext;
+    EXPECT_EQ(CopyCache.load(CopyContext), nullptr);
+}
+
+TEST_F(ResultCacheTest, store_and_load)
+{
+    ResultCache Cache((Dir / "cache").string(), "1.9.1");
+    ASSERT_TRUE(Cache.addFile(Input));
+
+    gtirb::Context Context;
+    EXPECT_EQ(Cache.load(Context), nullptr);
+
+    gtirb::IR* IR = gtirb::IR::Create(Context);
+    IR->addModule(Context, "cached");
+    ASSERT_TRUE(Cache.store(*IR));
+
+    gtirb::Context LoadContext;
+    gtirb::IR* Loaded = Cache.load(LoadContext);
+    ASSERT_NE(Loaded, nullptr);
+    ASSERT_EQ(std::distance(Loaded->modules_begin(), Loaded->modules_end()), 1);
+    EXPECT_EQ(Loaded->modules_begin()->getName(), "cached");
+
+    // A new ddisasm version does not see the entry.
+    ResultCache Newer((Dir / "cache").string(), "1.9.2");
+    ASSERT_TRUE(Newer.addFile(Input));
+    gtirb::Context NewerContext;
+    EXPECT_EQ(Newer.load(NewerContext), nullptr);
+}
@@ -153,3 +153,111 @@ TEST(Unit_SccPass, loops_and_call)
     EXPECT_NE(SccTable->find(B1->getUUID())->second, SccTable->find(B4->getUUID())->second);
     EXPECT_NE(SccTable->find(B2->getUUID())->second, SccTable->find(B4->getUUID())->second);
 }
+
+TEST(Unit_SccPass, module_scope)
+{
+    gtirb::Context Ctx;
+    gtirb::IR* IR = gtirb::IR::Create(Ctx);
+    gtirb::Module* M1 = IR->addModule(Ctx, "test1");
+    gtirb::Module* M2 = IR->addModule(Ctx, "test2");
+    gtirb::ByteInterval* I1 = M1->addSection(Ctx, "")->addByteInterval(Ctx, gtirb::Addr(0), 4);
+    gtirb::ByteInterval* I2 = M2->addSection(Ctx, "")->addByteInterval(Ctx, gtirb::Addr(0), 4);
+
+    gtirb::CodeBlock* B1 = I1->addBlock<gtirb::CodeBlock>(Ctx, 0, 1);
+    gtirb::CodeBlock* B2 = I1->addBlock<gtirb::CodeBlock>(Ctx, 1, 1);
+    gtirb::CodeBlock* B3 = I2->addBlock<gtirb::CodeBlock>(Ctx, 0, 1);
+    gtirb::CodeBlock* B4 = I2->addBlock<gtirb::CodeBlock>(Ctx, 1, 1);
+
+    gtirb::EdgeLabel SimpleJump = std::make_tuple(
+        gtirb::ConditionalEdge::OnFalse, gtirb::DirectEdge::IsDirect, gtirb::EdgeType::Branch);
+
+    gtirb::CFG& Cfg = IR->getCFG();
+    Cfg[*addEdge(B1, B2, Cfg)] = SimpleJump;
+    Cfg[*addEdge(B2, B1, Cfg)] = SimpleJump;
+    Cfg[*addEdge(B3, B4, Cfg)] = SimpleJump;
+
+    AnalysisPipeline Pipeline;
+    Pipeline.push<SccPass>();
+    Pipeline.run(Ctx, *M2);
+
+    // Only the blocks of the analyzed module are numbered.
+    auto* SccTable = M2->getAuxData<gtirb::schema::Sccs>();
+    EXPECT_EQ(SccTable->size(), 2U);
+    EXPECT_EQ(SccTable->count(B1->getUUID()), 0);
+    EXPECT_NE(SccTable->find(B3->getUUID())->second, SccTable->find(B4->getUUID())->second);
+}
+
+TEST(Unit_SccPass, long_loop)
+{
+    gtirb::Context Ctx;
+    gtirb::IR* IR = gtirb::IR::Create(Ctx);
+    gtirb::Module* M = IR->addModule(Ctx, "test");
+    const uint64_t Count = 100000;
+    gtirb::ByteInterval* I = M->addSection(Ctx, "")->addByteInterval(Ctx, gtirb::Addr(0), Count);
+
+    gtirb::EdgeLabel SimpleFallthrough = std::make_tuple(
+        gtirb::ConditionalEdge::OnFalse, gtirb::DirectEdge::IsDirect, gtirb::EdgeType::Fallthrough);
+    gtirb::EdgeLabel SimpleJump = std::make_tuple(
+        gtirb::ConditionalEdge::OnFalse, gtirb::DirectEdge::IsDirect, gtirb::EdgeType::Branch);
+
+    // A loop deep enough to overflow the stack of a recursive search.
+    gtirb::CFG& Cfg = IR->getCFG();
+    std::vector<gtirb::CodeBlock*> Blocks;
+    for(uint64_t Offset = 0; Offset < Count; Offset++)
+    {
+        Blocks.push_back(I->addBlock<gtirb::CodeBlock>(Ctx, Offset, 1));
+        if(Offset > 0)
+        {
+            Cfg[*addEdge(Blocks[Offset - 1], Blocks[Offset], Cfg)] = SimpleFallthrough;
+        }
+    }
+    Cfg[*addEdge(Blocks.back(), Blocks.front(), Cfg)] = SimpleJump;
+
+    AnalysisPipeline Pipeline;
+    Pipeline.push<SccPass>();
+    Pipeline.run(Ctx, *M);
+
+    auto* SccTable = M->getAuxData<gtirb::schema::Sccs>();
+    int64_t Scc = SccTable->find(Blocks.front()->getUUID())->second;
+    for(gtirb::CodeBlock* Block : Blocks)
+    {
+        EXPECT_EQ(SccTable->find(Block->getUUID())->second, Scc);
+    }
+}
+
+TEST(Unit_SccPass, module_order)
+{
+    gtirb::Context Ctx;
+    gtirb::IR* IR = gtirb::IR::Create(Ctx);
+    gtirb::Module* M = IR->addModule(Ctx, "test");
+    gtirb::Section* S = M->addSection(Ctx, "");
+    gtirb::ByteInterval* I = S->addByteInterval(Ctx, gtirb::Addr(0), 4);
+
+    // Blocks are added to the CFG in the opposite order of their addresses.
+    gtirb::CodeBlock* B3 = I->addBlock<gtirb::CodeBlock>(Ctx, 3, 1);
+    gtirb::CodeBlock* B2 = I->addBlock<gtirb::CodeBlock>(Ctx, 1, 1);
+    gtirb::CodeBlock* B1 = I->addBlock<gtirb::CodeBlock>(Ctx, 0, 1);
+    auto Proxy = gtirb::ProxyBlock::Create(Ctx);
+    M->addProxyBlock(Proxy);
+
+    gtirb::EdgeLabel SimpleJump = std::make_tuple(
+        gtirb::ConditionalEdge::OnFalse, gtirb::DirectEdge::IsDirect, gtirb::EdgeType::Branch);
+    gtirb::EdgeLabel SimpleCall = std::make_tuple(
+        gtirb::ConditionalEdge::OnFalse, gtirb::DirectEdge::IsDirect, gtirb::EdgeType::Call);
+
+    gtirb::CFG& Cfg = M->getIR()->getCFG();
+    Cfg[*addEdge(B1, B2, Cfg)] = SimpleJump;
+    Cfg[*addEdge(B2, B1, Cfg)] = SimpleJump;
+    Cfg[*addEdge(B3, Proxy, Cfg)] = SimpleCall;
+
+    AnalysisPipeline Pipeline;
+    Pipeline.push<SccPass>();
+    Pipeline.run(Ctx, *M);
+
+    // SCC ids follow the order of the blocks in the module, not the order of the CFG.
+    auto* SccTable = M->getAuxData<gtirb::schema::Sccs>();
+    EXPECT_EQ(SccTable->at(B1->getUUID()), 0);
+    EXPECT_EQ(SccTable->at(B2->getUUID()), 0);
+    EXPECT_EQ(SccTable->at(B3->getUUID()), 1);
+    EXPECT_EQ(SccTable->at(Proxy->getUUID()), 2);
+}
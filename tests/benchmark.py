@@ -0,0 +1,363 @@
+"""
+Performance regression harness for ddisasm.
+
+Build the corpus described in benchmark.yaml, including synthetic binaries
+of increasing size, disassemble every binary a few times, and record the
+time, peak memory, per-pass and per-phase times, and relation sizes
+reported by `ddisasm --report`. The results can be saved as a baseline and
+later runs compared against it; any measurement that exceeds the baseline by
+more than the tolerance is reported and makes the harness fail. Times that
+grow by less than an absolute floor are ignored, as short passes vary by
+more than the tolerance from run to run.
+"""
+import argparse
+import json
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+from pathlib import Path
+from timeit import default_timer as timer
+from typing import Dict, List, Optional
+
+import yaml
+
+import synthetic_binary
+from disassemble_reassemble_check import bcolors, cd, compile
+
+# Columns of the scaling report for the synthetic binaries: the header and
+# the time of a pass, a pass phase ("pass/phase") or the size of a relation.
+SCALING_COLUMNS = [
+    ("disassembly", "passes", "disassembly"),
+    ("no return", "passes", "no return analysis"),
+    ("no ret. xform", "phases", "no return analysis/transform"),
+    ("cfg edges", "relations", "no return analysis/cfg_edge"),
+    ("func. infer.", "passes", "function inference"),
+]
+
+
+def run_ddisasm(
+    ddisasm: str, binary: Path, work_dir: Path, threads: int
+) -> Optional[dict]:
+    """
+    Disassemble 'binary' once and return its measurements, or None if
+    ddisasm failed.
+    """
+    report_path = work_dir / "report.json"
+    cmd = [
+        ddisasm,
+        str(binary),
+        "--ir",
+        str(work_dir / "out.gtirb"),
+        "-j",
+        str(threads),
+        "--report",
+        str(report_path),
+        "--report-relations",
+    ]
+    start = timer()
+    process = subprocess.Popen(
+        cmd, stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL
+    )
+    _, status, usage = os.wait4(process.pid, 0)
+    elapsed = timer() - start
+    process.returncode = os.waitstatus_to_exitcode(status)
+    if process.returncode != 0:
+        return None
+
+    with open(report_path) as f:
+        report = json.load(f)
+
+    passes = {}
+    phases = {}
+    relations = {}
+    for module in report["modules"]:
+        for pass_ in module["passes"]:
+            name = pass_["name"]
+            for phase in ("load", "compute", "transform"):
+                if phase not in pass_:
+                    continue
+                wall_time = pass_[phase]["wall_time"]
+                passes[name] = passes.get(name, 0.0) + wall_time
+                key = f"{name}/{phase}"
+                phases[key] = phases.get(key, 0.0) + wall_time
+            for kind in ("input_relations", "output_relations"):
+                for relation, size in pass_.get(kind, {}).items():
+                    key = f"{name}/{relation}"
+                    relations[key] = relations.get(key, 0) + size
+
+    return {
+        "time": elapsed,
+        # ru_maxrss is reported in KiB on Linux.
+        "peak_memory": usage.ru_maxrss * 1024,
+        "passes": passes,
+        "phases": phases,
+        "relations": relations,
+    }
+
+
+def best_of(runs: List[dict]) -> dict:
+    """
+    Combine repeated runs, keeping the fastest time of each measurement.
+    Memory and relation sizes are deterministic up to noise, so the smallest
+    peak and the sizes of the last run are used.
+    """
+    return {
+        "time": min(run["time"] for run in runs),
+        "peak_memory": min(run["peak_memory"] for run in runs),
+        "passes": {
+            name: min(run["passes"].get(name, 0.0) for run in runs)
+            for name in runs[-1]["passes"]
+        },
+        "phases": {
+            name: min(run["phases"].get(name, 0.0) for run in runs)
+            for name in runs[-1]["phases"]
+        },
+        "relations": runs[-1]["relations"],
+    }
+
+
+def build_corpus(config: dict, work_dir: Path) -> Dict[str, Path]:
+    """
+    Build every example of every architecture whose compiler is installed.
+    Returns the binaries indexed by benchmark name.
+    """
+    binaries = {}
+    for arch, arch_config in config["architectures"].items():
+        if not shutil.which(arch_config["c"]):
+            print(bcolors.warning(f"# Skipping {arch}: no compiler"))
+            continue
+        for example in arch_config["examples"]:
+            path = Path(arch_config["path"]) / example
+            for optimization in arch_config["optimizations"]:
+                name = f"{arch}/{example}/{optimization}"
+                with cd(path):
+                    built = compile(
+                        arch_config["c"],
+                        arch_config["cpp"],
+                        optimization,
+                        arch_config["flags"],
+                    )
+                if not built:
+                    print(bcolors.warning(f"# Failed to build {name}"))
+                    continue
+                binary = work_dir / name.replace("/", "_")
+                shutil.copy(path / arch_config["binary"], binary)
+                binaries[name] = binary
+
+        synthetic = config.get("synthetic")
+        if not synthetic:
+            continue
+        for functions in synthetic["functions"]:
+            params = synthetic_binary.Parameters(
+                functions=functions,
+                switch_ratio=synthetic["switch_ratio"],
+                switch_cases=synthetic["switch_cases"],
+                noreturn_ratio=synthetic["noreturn_ratio"],
+                strings=synthetic["strings"],
+                string_length=synthetic["string_length"],
+                seed=synthetic["seed"],
+            )
+            for optimization in synthetic["optimizations"]:
+                name = f"{arch}/synthetic-{functions}/{optimization}"
+                binary = work_dir / name.replace("/", "_")
+                sources = synthetic_binary.generate(
+                    params, work_dir / (binary.name + ".src")
+                )
+                built = synthetic_binary.build(
+                    sources,
+                    binary,
+                    arch_config["c"],
+                    [optimization, *arch_config["flags"]],
+                    os.cpu_count(),
+                )
+                if not built:
+                    print(bcolors.warning(f"# Failed to build {name}"))
+                    continue
+                binaries[name] = binary
+    return binaries
+
+
+def print_scaling(results: dict) -> None:
+    """
+    Print how the time and memory of the main passes grow with the size of
+    the synthetic binaries. Times are in seconds.
+    """
+    rows = [
+        (name, result)
+        for name, result in results["benchmarks"].items()
+        if "/synthetic-" in name
+    ]
+    if not rows:
+        return
+    print("# Scaling on synthetic binaries")
+    print(
+        f"{'binary':<36}{'size':>10}{'memory':>10}"
+        + "".join(f"{header:>16}" for header, _, _ in SCALING_COLUMNS)
+    )
+    for name, result in rows:
+        columns = []
+        for _, kind, key in SCALING_COLUMNS:
+            value = result.get(kind, {}).get(key, 0)
+            if kind == "relations":
+                columns.append(f"{value:>16}")
+            else:
+                columns.append(f"{value:>16.3f}")
+        print(
+            f"{name:<36}{result['size'] / 2**20:>8.1f}MB"
+            f"{result['peak_memory'] / 2**20:>7.0f}MiB" + "".join(columns)
+        )
+
+
+def compare(
+    results: dict,
+    baseline: dict,
+    time_tolerance: float,
+    memory_tolerance: float,
+    relation_tolerance: float,
+    time_floor: float = 0.0,
+) -> List[str]:
+    """
+    Return a description of every measurement that regressed with respect to
+    the baseline. Times that grew by less than time_floor seconds are not
+    regressions.
+    """
+
+    def check(name, metric, value, reference, tolerance, unit="", floor=0.0):
+        if value - reference < floor:
+            return
+        if reference > 0 and value > reference * (1.0 + tolerance):
+            increase = 100.0 * (value / reference - 1.0)
+            regressions.append(
+                f"{name}: {metric} {value:.3f}{unit} vs {reference:.3f}{unit}"
+                f" (+{increase:.1f}%)"
+            )
+
+    regressions = []
+    for name, reference in baseline["benchmarks"].items():
+        result = results["benchmarks"].get(name)
+        if result is None:
+            print(bcolors.warning(f"# {name} is missing from this run"))
+            continue
+        check(
+            name,
+            "time",
+            result["time"],
+            reference["time"],
+            time_tolerance,
+            "s",
+            time_floor,
+        )
+        check(
+            name,
+            "peak memory",
+            result["peak_memory"] / 2**20,
+            reference["peak_memory"] / 2**20,
+            memory_tolerance,
+            "MiB",
+        )
+        for pass_, time in reference["passes"].items():
+            check(
+                name,
+                f"{pass_} time",
+                result["passes"].get(pass_, 0.0),
+                time,
+                time_tolerance,
+                "s",
+                time_floor,
+            )
+        for relation, size in reference["relations"].items():
+            check(
+                name,
+                f"{relation} size",
+                result["relations"].get(relation, 0),
+                size,
+                relation_tolerance,
+            )
+    return regressions
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description=__doc__.strip())
+    parser.add_argument("--ddisasm", default="ddisasm", help="ddisasm binary")
+    parser.add_argument(
+        "--config",
+        default=str(Path(__file__).parent / "benchmark.yaml"),
+        help="corpus configuration",
+    )
+    parser.add_argument("--output", help="write the results to this file")
+    parser.add_argument("--baseline", help="compare against these results")
+    parser.add_argument("--repeat", type=int, help="runs per binary")
+    parser.add_argument("-j", "--threads", type=int, default=1)
+    parser.add_argument("--time-tolerance", type=float, default=0.10)
+    parser.add_argument(
+        "--time-floor",
+        type=float,
+        default=0.05,
+        help="ignore time increases below this many seconds",
+    )
+    parser.add_argument("--memory-tolerance", type=float, default=0.10)
+    parser.add_argument("--relation-tolerance", type=float, default=0.02)
+    args = parser.parse_args()
+
+    with open(args.config) as f:
+        config = yaml.safe_load(f)
+    repeat = args.repeat or config.get("repeat", 3)
+
+    version = subprocess.run(
+        [args.ddisasm, "--version"], capture_output=True, text=True
+    ).stdout.strip()
+    results = {"version": version, "benchmarks": {}}
+
+    with tempfile.TemporaryDirectory() as tmp:
+        work_dir = Path(tmp)
+        binaries = build_corpus(config, work_dir)
+        for name, binary in binaries.items():
+            print(f"# Benchmarking {name}")
+            runs = []
+            for _ in range(repeat):
+                run = run_ddisasm(args.ddisasm, binary, work_dir, args.threads)
+                if run is None:
+                    break
+                runs.append(run)
+            if len(runs) < repeat:
+                print(bcolors.fail(f"# ddisasm failed on {name}"))
+                return 1
+            results["benchmarks"][name] = best_of(runs)
+            results["benchmarks"][name]["size"] = binary.stat().st_size
+            result = results["benchmarks"][name]
+            print(
+                f"    {result['time']:.3f}s"
+                f" {result['peak_memory'] / 2**20:.1f}MiB"
+            )
+
+    print_scaling(results)
+
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump(results, f, indent=2, sort_keys=True)
+
+    if not args.baseline:
+        return 0
+
+    with open(args.baseline) as f:
+        baseline = json.load(f)
+    regressions = compare(
+        results,
+        baseline,
+        args.time_tolerance,
+        args.memory_tolerance,
+        args.relation_tolerance,
+        args.time_floor,
+    )
+    for regression in regressions:
+        print(bcolors.fail(f"# Regression: {regression}"))
+    if regressions:
+        return 1
+    print(bcolors.okgreen("# No regressions"))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
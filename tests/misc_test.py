@@ -1,3 +1,5 @@
+import fnmatch
+import importlib.util
 import os
 import platform
 import unittest
@@ -335,6 +337,136 @@ class AuxDataTests(unittest.TestCase):
             # compare the relations directories
             subprocess.check_call(["diff", "dbg", "aux"])
 
+    def test_souffle_relations_binary(self):
+        """
+        Test `--with-souffle-relations --souffle-relations-format compressed'
+        equivalence to `--debug-dir'.
+        """
+        spec = importlib.util.spec_from_file_location(
+            "relations",
+            Path(__file__).parent.parent / "python/src/ddisasm/relations.py",
+        )
+        relations = importlib.util.module_from_spec(spec)
+        spec.loader.exec_module(relations)
+
+        with cd(ex_dir / "ex1"):
+            # build
+            self.assertTrue(compile("gcc", "g++", "-O0", []))
+
+            # disassemble
+            if not os.path.exists("dbg_bin"):
+                os.mkdir("dbg_bin")
+            ir = disassemble(
+                Path("ex"),
+                extra_args=[
+                    "-F",
+                    "--with-souffle-relations",
+                    "--souffle-relations-format",
+                    "compressed",
+                    "--debug-dir",
+                    "dbg_bin",
+                ],
+            ).ir()
+
+            # load the gtirb
+            m = ir.modules[0]
+            self.assertNotIn("souffleFacts", m.aux_data)
+            self.assertNotIn("souffleOutputs", m.aux_data)
+
+            # dump relations to directory
+            if not os.path.exists("aux_bin"):
+                os.mkdir("aux_bin")
+            for table, ext in [
+                ("souffleFactsBinary", "facts"),
+                ("souffleOutputsBinary", "csv"),
+            ]:
+                tables = relations.aux_data_relations(m, table)
+                for name, relation in tables.items():
+                    dirname, filename = name.split(".", 1)
+                    path = Path("aux_bin", dirname, f"{filename}.{ext}")
+                    path.parent.mkdir(parents=True, exist_ok=True)
+                    with open(path, "w") as out:
+                        out.writelines(relations.to_csv(relation))
+
+            # compare the relations directories
+            subprocess.check_call(["diff", "dbg_bin", "aux_bin"])
+
+    def test_relations_csv_path(self):
+        """
+        Test the names of the CSV files converted from binary relations.
+        """
+        spec = importlib.util.spec_from_file_location(
+            "relations",
+            Path(__file__).parent.parent / "python/src/ddisasm/relations.py",
+        )
+        relations = importlib.util.module_from_spec(spec)
+        spec.loader.exec_module(relations)
+
+        for binary, csv in [
+            ("dbg/instruction.facts.bin", "dbg/instruction.facts"),
+            ("dbg/code_in_block.bin", "dbg/code_in_block.csv"),
+            ("dbg/reg_def_use.def_used.bin", "dbg/reg_def_use.def_used.csv"),
+            (
+                "dbg/stack_def_use.def_used.bin",
+                "dbg/stack_def_use.def_used.csv",
+            ),
+        ]:
+            self.assertEqual(relations._csv_path(Path(binary)), Path(csv))
+
+    def test_souffle_relations_filter(self):
+        """
+        Test that `--select-relations' and `--exclude-relations' restrict the
+        relations of `--with-souffle-relations' and `--debug-dir'.
+        """
+        selected = [
+            "disassembly.symbolic_operand",
+            "*.value_reg",
+            "*.code_in_*",
+        ]
+        excluded = ["*.code_in_block_candidate*"]
+
+        with cd(ex_dir / "ex1"):
+            # build
+            self.assertTrue(compile("gcc", "g++", "-O0", []))
+
+            # disassemble
+            if not os.path.exists("dbg_filter"):
+                os.mkdir("dbg_filter")
+            ir = disassemble(
+                Path("ex"),
+                extra_args=[
+                    "--with-souffle-relations",
+                    "--debug-dir",
+                    "dbg_filter",
+                    "--select-relations",
+                    *selected,
+                    "--exclude-relations",
+                    *excluded,
+                ],
+            ).ir()
+            m = ir.modules[0]
+
+            names = set(m.aux_data["souffleFacts"].data)
+            names |= set(m.aux_data["souffleOutputs"].data)
+            self.assertIn("disassembly.symbolic_operand", names)
+            self.assertIn("disassembly.value_reg", names)
+            self.assertIn("disassembly.code_in_refined_block", names)
+            for name in names:
+                self.assertTrue(
+                    any(fnmatch.fnmatchcase(name, p) for p in selected), name
+                )
+                self.assertFalse(
+                    any(fnmatch.fnmatchcase(name, p) for p in excluded), name
+                )
+
+            # the debug directory holds the same relations
+            files = {
+                f"{path.parent.name}.{path.stem}"
+                for path in Path("dbg_filter").glob("*/*")
+                if path.suffix in (".facts", ".csv")
+            }
+            self.assertEqual(files, names)
+
     def assert_regex_match(self, text, pattern):
         """
         Like unittest's assertRegex, but also return the match object on
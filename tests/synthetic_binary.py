@@ -0,0 +1,230 @@
+"""
+Generate reproducible synthetic binaries for ddisasm scaling tests.
+
+The generator writes C sources with a tunable mix of plain functions, switch
+statements compiled to jump tables, functions that do not return, and pools
+of strings and pointers in read-only data, then builds them with the given
+compiler. The architecture and format (ELF or PE) of the result are those of
+the compiler, e.g. `aarch64-linux-gnu-gcc` or `x86_64-w64-mingw32-gcc`.
+The same seed and parameters always produce the same sources.
+"""
+import argparse
+import os
+import random
+import subprocess
+import sys
+from concurrent.futures import ThreadPoolExecutor
+from dataclasses import dataclass
+from pathlib import Path
+from typing import List
+
+# Functions per translation unit, to keep compile times manageable.
+UNIT_SIZE = 2000
+
+
+@dataclass
+class Parameters:
+    functions: int = 10000
+    switch_ratio: float = 0.1
+    switch_cases: int = 64
+    noreturn_ratio: float = 0.02
+    strings: int = 10000
+    string_length: int = 32
+    seed: int = 1
+
+
+def function_source(rng: random.Random, index: int, p: Parameters) -> str:
+    """
+    Return the source of function 'index'. Functions call a few earlier ones
+    so that the call graph is connected.
+    """
+    callees = [rng.randrange(index) for _ in range(min(index, 2))]
+    prototypes = "".join(f"int f{c}(int x);\n" for c in callees)
+    calls = "".join(f"    x = f{c}(x);\n" for c in callees)
+    kind = rng.random()
+    if kind < p.noreturn_ratio:
+        return prototypes + (
+            f"__attribute__((noreturn)) void n{index}(int x)\n"
+            "{\n"
+            f'    fprintf(stderr, "%d", x);\n'
+            f"    exit({index % 128});\n"
+            "}\n"
+            f"int f{index}(int x)\n"
+            "{\n"
+            f"{calls}"
+            f"    if(x == {rng.randrange(1 << 30)})\n"
+            f"        n{index}(x);\n"
+            "    return x + 1;\n"
+            "}\n"
+        )
+    if kind < p.noreturn_ratio + p.switch_ratio:
+        cases = "".join(
+            f"    case {c}: x = x * {rng.randrange(1, 100)} + {c}; break;\n"
+            for c in range(p.switch_cases)
+        )
+        return prototypes + (
+            f"int f{index}(int x)\n"
+            "{\n"
+            f"{calls}"
+            f"    switch(x % {p.switch_cases})\n"
+            "    {\n"
+            f"{cases}"
+            "    default: x = -x;\n"
+            "    }\n"
+            "    return x;\n"
+            "}\n"
+        )
+    return prototypes + (
+        f"int f{index}(int x)\n"
+        "{\n"
+        f"{calls}"
+        f"    x ^= {rng.randrange(1 << 30)};\n"
+        f"    x = (x << {rng.randrange(1, 8)}) + strings[x & {p.strings - 1}]"
+        f"[{rng.randrange(p.string_length)}];\n"
+        "    return x;\n"
+        "}\n"
+    )
+
+
+def string_literal(rng: random.Random, length: int) -> str:
+    alphabet = "abcdefghijklmnopqrstuvwxyz0123456789 "
+    return "".join(rng.choice(alphabet) for _ in range(length))
+
+
+def generate(p: Parameters, out_dir: Path) -> List[Path]:
+    """
+    Write the sources of a synthetic program to 'out_dir' and return them.
+    """
+    # Power of two so that string indices can be masked.
+    p.strings = 1 << max(p.strings - 1, 1).bit_length()
+    rng = random.Random(p.seed)
+    out_dir.mkdir(parents=True, exist_ok=True)
+    header = (
+        "#include <stdio.h>\n"
+        "#include <stdlib.h>\n"
+        "extern const char *const strings[];\n"
+    )
+    sources = []
+
+    units = (p.functions + UNIT_SIZE - 1) // UNIT_SIZE
+    for unit in range(units):
+        begin = unit * UNIT_SIZE
+        end = min(begin + UNIT_SIZE, p.functions)
+        path = out_dir / f"unit{unit}.c"
+        with open(path, "w") as f:
+            f.write(header)
+            for i in range(begin, end):
+                f.write(function_source(rng, i, p))
+        sources.append(path)
+
+    path = out_dir / "main.c"
+    with open(path, "w") as f:
+        f.write(header)
+        for i in range(p.functions):
+            f.write(f"int f{i}(int x);\n")
+        f.write("const char *const strings[] = {\n")
+        for _ in range(p.strings):
+            f.write(f'    "{string_literal(rng, p.string_length)}",\n')
+        f.write("};\n")
+        f.write("int (*const functions[])(int) = {\n")
+        for i in range(p.functions):
+            f.write(f"    f{i},\n")
+        f.write("};\n")
+        f.write(
+            "int main(int argc, char **argv)\n"
+            "{\n"
+            "    int x = argc;\n"
+            f"    for(int i = 0; i < {p.functions}; i += argc + 1)\n"
+            f"        x = functions[(unsigned)(i + x) % {p.functions}](x);\n"
+            "    return x & 1;\n"
+            "}\n"
+        )
+    sources.append(path)
+    return sources
+
+
+def build(
+    sources: List[Path],
+    output: Path,
+    compiler: str,
+    flags: List[str],
+    jobs: int,
+) -> bool:
+    """
+    Compile 'sources' in parallel and link them into 'output'.
+    """
+
+    def compile_unit(source: Path) -> int:
+        cmd = [compiler, "-c", str(source), "-o", str(source) + ".o"]
+        return subprocess.run(cmd + flags).returncode
+
+    with ThreadPoolExecutor(max_workers=jobs) as pool:
+        if any(code != 0 for code in pool.map(compile_unit, sources)):
+            return False
+    objects = [str(source) + ".o" for source in sources]
+    cmd = [compiler, *objects, "-o", str(output)] + flags
+    return subprocess.run(cmd).returncode == 0
+
+
+def main() -> int:
+    defaults = Parameters()
+    parser = argparse.ArgumentParser(description=__doc__.strip())
+    parser.add_argument("output", help="binary to generate")
+    parser.add_argument("--compiler", default="gcc")
+    parser.add_argument("--flags", nargs="*", default=["-O1"])
+    parser.add_argument("--functions", type=int, default=defaults.functions)
+    parser.add_argument(
+        "--switch-ratio",
+        type=float,
+        default=defaults.switch_ratio,
+        help="fraction of functions with a jump table",
+    )
+    parser.add_argument(
+        "--switch-cases",
+        type=int,
+        default=defaults.switch_cases,
+        help="entries of each jump table",
+    )
+    parser.add_argument(
+        "--noreturn-ratio",
+        type=float,
+        default=defaults.noreturn_ratio,
+        help="fraction of functions calling a function that does not return",
+    )
+    parser.add_argument(
+        "--strings",
+        type=int,
+        default=defaults.strings,
+        help="strings in the read-only string pool",
+    )
+    parser.add_argument(
+        "--string-length", type=int, default=defaults.string_length
+    )
+    parser.add_argument("--seed", type=int, default=defaults.seed)
+    parser.add_argument("-j", "--jobs", type=int, default=os.cpu_count())
+    parser.add_argument(
+        "--source-dir",
+        help="where to write the sources (default: next to the output)",
+    )
+    args = parser.parse_args()
+
+    params = Parameters(
+        functions=args.functions,
+        switch_ratio=args.switch_ratio,
+        switch_cases=args.switch_cases,
+        noreturn_ratio=args.noreturn_ratio,
+        strings=args.strings,
+        string_length=args.string_length,
+        seed=args.seed,
+    )
+    output = Path(args.output)
+    source_dir = Path(args.source_dir or str(output) + ".src")
+    sources = generate(params, source_dir)
+    if not build(sources, output, args.compiler, args.flags, args.jobs):
+        print(f"error: failed to build {output}", file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())